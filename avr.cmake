@@ -42,6 +42,21 @@ set(micro_multi_BUILD_TYPE main)
 set(uno_VARIANTS "uno;mega2560;megaadk;mini")
 set(micro_VARIANTS "micro;a-micro;leonardo")
 set(F_CPU_8_mini TRUE)
+if(TRACE_STAGES)
+  set(AVR_TRACE 1)
+endif()
+if(RECORD_INPUTS)
+  set(AVR_RECORD 1)
+endif()
+if(CAPTURE_EDGES)
+  set(AVR_CAPTURE 1)
+endif()
+if(ADC_SCAN)
+  set(AVR_SCAN 1)
+endif()
+if(BAKED_CONFIG)
+  set(AVR_BAKED ${BAKED_CONFIG})
+endif()
 set(F_CPU_8_micro TRUE)
 foreach(PROJECT ${PROJECTS})
   foreach(VARIANT ${${PROJECT}_VARIANTS})
@@ -102,7 +117,7 @@ foreach(PROJECT ${PROJECTS})
             COMMAND
               make OBJDIR=${OBJDIRF} VERSION_MAJOR=${VERSION_MAJOR} VERSION_MINOR=${VERSION_MINOR}
               VERSION_REVISION=${VERSION_REVISION} F_USB=${F_CPU} F_CPU=${F_CPU}
-              ARDUINO_MODEL_PID=${PID} ARDWIINO_BOARD=${VARIANT} EXTRA=${EXTRA}
+              ARDUINO_MODEL_PID=${PID} ARDWIINO_BOARD=${VARIANT} EXTRA=${EXTRA} TRACE=${AVR_TRACE} RECORD=${AVR_RECORD} CAPTURE=${AVR_CAPTURE} SCAN=${AVR_SCAN} BAKED=${AVR_BAKED}
               TARGET=${OUT} MCU=${MCU} VARIANT=${${VARIANT}_VARIANT}
             WORKING_DIRECTORY ${IN}
             BYPRODUCTS ${OBJDIRF} ${OUTPUTS})
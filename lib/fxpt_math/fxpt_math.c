@@ -26,6 +26,14 @@
 #include <math.h>
 #include <stdint.h>
 #include "fxpt_math.h"
+#ifdef __AVR__
+#  include <avr/pgmspace.h>
+#else
+#  ifndef PROGMEM
+#    define PROGMEM
+#  endif
+#  define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#endif
 
 /**
  * Convert floating point to Q15 (1.0.15 fixed point) format.
@@ -142,6 +150,83 @@ uint16_t fxpt_atan2(const int16_t y, const int16_t x) {
     }
   }
 }
+/**
+ * atan(i / 64) for i from 0 to 64, in 1/65536ths of one turn.
+ */
+static const uint16_t atan_table[65] PROGMEM = {
+    0,    163,  326,  489,  651,  813,  975,  1136, 1297, 1457, 1617,
+    1775, 1933, 2090, 2246, 2401, 2555, 2708, 2860, 3010, 3159, 3307,
+    3453, 3599, 3742, 3884, 4025, 4164, 4302, 4438, 4572, 4705, 4836,
+    4966, 5094, 5220, 5344, 5467, 5589, 5708, 5826, 5943, 6058, 6171,
+    6282, 6392, 6500, 6607, 6712, 6815, 6917, 7018, 7117, 7214, 7310,
+    7405, 7498, 7589, 7679, 7768, 7856, 7942, 8026, 8110, 8192};
+
+/**
+ * First octant arctangent of num / denom, from the table above.
+ *
+ * The ratio is found to 14 bits. The avr has no divide instruction, so there
+ * that is done by shift and subtract, which is far cheaper than the 32-bit
+ * library division and only needs 16-bit registers since num < denom <= 32768.
+ * Anything with a divider just divides. The top 6 bits pick a table entry and
+ * the bottom 8 interpolate to the next one, and as neighbouring entries are
+ * never more than 163 apart that is an 8 by 8 bit multiply.
+ *
+ * @param num smaller magnitude
+ * @param denom larger magnitude, must be greater than num
+ * @return angle from 0 to 8192 (1/8 turn)
+ */
+static uint16_t atan_octant(uint16_t num, uint16_t denom) {
+#ifdef __AVR__
+  uint16_t ratio = 0;
+  for (uint8_t i = 0; i < 14; i++) {
+    num <<= 1;
+    ratio <<= 1;
+    if (num >= denom) {
+      num -= denom;
+      ratio |= 1;
+    }
+  }
+#else
+  const uint16_t ratio = ((uint32_t)num << 14) / denom;
+#endif
+  const uint8_t idx = ratio >> 8;
+  const uint8_t frac = ratio;
+  const uint16_t base = pgm_read_word(&atan_table[idx]);
+  const uint8_t step = pgm_read_word(&atan_table[idx + 1]) - base;
+  return base + (((uint16_t)step * frac + 0x80) >> 8);
+}
+
+/**
+ * Table based 16-bit fixed point four-quadrant arctangent, with the same
+ * inputs and output as fxpt_atan2.
+ *
+ * The error is at most 2/65536ths of one turn (about 0.011 degrees): the
+ * ratio is truncated to 14 bits (0.64), interpolating between entries is out
+ * by up to 0.21, and the table and the final result are each rounded (0.5
+ * each). fxpt_atan2's polynomial is out by up to about 0.0038 radians, so 40
+ * or so of the same units, and needs a 32-bit division.
+ *
+ * @param y y-coordinate in signed 16-bit
+ * @param x x-coordinate in signed 16-bit
+ * @return angle in (val / 32768) * pi radian increments from 0x0000 to 0xFFFF
+ */
+uint16_t fxpt_atan2_fast(const int16_t y, const int16_t x) {
+  // Unsigned, so that -32768 has a magnitude too
+  const uint16_t abs_x = x < 0 ? -(uint16_t)x : (uint16_t)x;
+  const uint16_t abs_y = y < 0 ? -(uint16_t)y : (uint16_t)y;
+  uint16_t angle;
+  if (abs_x == abs_y) {
+    if (!abs_x) { return 0; }
+    angle = 8192;
+  } else if (abs_y < abs_x) { // octant 1
+    angle = atan_octant(abs_y, abs_x);
+  } else { // octant 2
+    angle = 16384 - atan_octant(abs_x, abs_y);
+  }
+  if (x < 0) { angle = 32768 - angle; }
+  if (y < 0) { angle = -angle; }
+  return angle;
+}
 uint16_t fxpt_asin(int16_t x) {
   int16_t x8, x4, x2;
   x2 = q15_mul(x, x);
@@ -43,4 +43,14 @@
  * @return angle in (val / 32768) * pi radian increments from 0x0000 to 0xFFFF
  */
 uint16_t fxpt_atan2(const int16_t y, const int16_t x);
+/**
+ * Same as fxpt_atan2, but from a lookup table, with no multiplication wider
+ * than 8 bits and no division on the avr. Out by at most 2/65536ths of one
+ * turn.
+ *
+ * @param y y-coordinate in signed 16-bit
+ * @param x x-coordinate in signed 16-bit
+ * @return angle in (val / 32768) * pi radian increments from 0x0000 to 0xFFFF
+ */
+uint16_t fxpt_atan2_fast(const int16_t y, const int16_t x);
 uint16_t fxpt_asin(int16_t x);
\ No newline at end of file
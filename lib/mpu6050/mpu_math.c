@@ -13,13 +13,13 @@ void quaternionToEuler(const struct s_quat *q, int16_t *out, uint8_t angle) {
   sqw = q->w * q->w;
   switch (angle) {
     case X:
-      *out = fxpt_atan2(2 * (q->x * q->y - q->z * q->w), 32768 - 2 * (sqy + sqz));
+      *out = fxpt_atan2_fast(2 * (q->x * q->y - q->z * q->w), 32768 - 2 * (sqy + sqz));
       break;
     case Y:
       *out = fxpt_asin(test);
       break;
     case Z:
-      *out = fxpt_atan2(2 * (q->x * q->w + q->y * q->z), 32768 - 2 * (sqz + sqw));
+      *out = fxpt_atan2_fast(2 * (q->x * q->w + q->y * q->z), 32768 - 2 * (sqz + sqw));
       break;
   }
   if (*out > MAX) {
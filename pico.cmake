@@ -16,7 +16,11 @@ foreach(TYPE ${TYPES})
     src/shared/output/control_requests.c
     src/shared/output/descriptors.c
     src/shared/output/serial_handler.c
+    src/shared/stats/stats.c
+    src/shared/stats/trace.c
+    src/shared/stats/record.c
     src/shared/output/reports.c
+    src/shared/output/scheduler.c
     src/shared/leds/leds.c
     src/shared/rf/rf.c
     src/shared/input/input_handler.c
@@ -46,6 +50,23 @@ foreach(TYPE ${TYPES})
   if(${EXTRA} MATCHES "-rf")
     target_compile_definitions(${TARGET} PUBLIC RF_TX=true)
   endif()
+  if(TRACE_STAGES)
+    target_compile_definitions(${TARGET} PUBLIC TRACE_STAGES=1)
+  endif()
+  if(RECORD_INPUTS)
+    target_compile_definitions(${TARGET} PUBLIC RECORD_INPUTS=1)
+  endif()
+  if(CAPTURE_EDGES)
+    target_compile_definitions(${TARGET} PUBLIC CAPTURE_EDGES=1)
+  endif()
+  if(ADC_SCAN)
+    target_compile_definitions(${TARGET} PUBLIC ADC_SCAN=1)
+    target_link_libraries(${TARGET} hardware_dma)
+  endif()
+  if(BAKED_CONFIG)
+    target_compile_definitions(${TARGET} PUBLIC BAKED_CONFIG=1)
+    target_include_directories(${TARGET} PUBLIC ${BAKED_CONFIG})
+  endif()
   set(XIP_BASE 0x10000000)
   math(EXPR RF_TARGET_OFFSET "(256 * 1024)" OUTPUT_FORMAT HEXADECIMAL)
   math(EXPR FLASH_TARGET_OFFSET "(512 * 1024)" OUTPUT_FORMAT HEXADECIMAL)
@@ -0,0 +1,54 @@
+#!/usr/bin/env python
+# Captures inputs from a controller running firmware built with RECORD_INPUTS,
+# for replaying with src/host/replay. Stop with ctrl+c.
+# usage: record.py output.bin
+import struct
+import sys
+import time
+import usb.core
+
+# Must match src/shared/output/serial_commands.h
+COMMAND_READ_CONFIG = 0x3E
+COMMAND_GET_RECORDING = 0x62
+CONFIG_BLOCK = 50
+RECORD_FLAG_OVERFLOW = 1
+# Must match src/host/replay/main.c
+MAGIC = b"ARDWREC1"
+
+def get_feature(dev, cmd):
+    return bytes(dev.ctrl_transfer(0xa1, 0x01, 0x0300 | cmd, 0x00, 64))
+
+dev = usb.core.find(idVendor=0x1209, idProduct=0x2882)
+if dev is None:
+    sys.exit("No controller found")
+try:
+    dev.detach_kernel_driver(0)
+except usb.core.USBError:
+    print("Probably already detached")
+
+config = b""
+block = COMMAND_READ_CONFIG
+while True:
+    data = get_feature(dev, block)
+    config += data
+    block += 1
+    if len(data) < CONFIG_BLOCK:
+        break
+
+records = 0
+with open(sys.argv[1], "wb") as out:
+    out.write(MAGIC + struct.pack("<H", len(config)) + config)
+    try:
+        while True:
+            data = get_feature(dev, COMMAND_GET_RECORDING)
+            if data[0] & RECORD_FLAG_OVERFLOW:
+                print("Recording overflowed, some inputs were lost")
+            if len(data) > 1:
+                out.write(data[1:])
+                records += 1
+            else:
+                # Nothing was waiting, give the controller a moment
+                time.sleep(0.001)
+    except KeyboardInterrupt:
+        pass
+print("Captured %d reads" % records)
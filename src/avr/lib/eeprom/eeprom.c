@@ -6,7 +6,15 @@
 static uint8_t EEMEM test = 0;
 static Configuration_t EEMEM config_pointer = DEFAULT_CONFIG;
 const Configuration_t PROGMEM default_config = DEFAULT_CONFIG;
+#ifdef BAKED_CONFIG
+static const uint8_t PROGMEM baked_config[sizeof(Configuration_t)] = {
+    BAKED_CONFIG_BYTES};
+#endif
 void loadConfig(Configuration_t *config) {
+#ifdef BAKED_CONFIG
+  memcpy_P(config, baked_config, sizeof(Configuration_t));
+  return;
+#endif
   eeprom_read_block(config, &config_pointer, sizeof(Configuration_t));
   // Do this first, as previous controllers will have their config stored in a
   // different location, and then the following changes will be to an invalid
@@ -21,6 +29,17 @@ void loadConfig(Configuration_t *config) {
     writeConfigBlock(0, (uint8_t *)config, sizeof(Configuration_t));
     return;
   }
+  // Version 19 made DebounceConfig_t bigger, so everything after it needs to
+  // move along before anything else touches it.
+  if (config->main.version < 19) {
+    memmove(&config->neck,
+            ((uint8_t *)&config->neck) - sizeof(config->debounce.eagerButtons) -
+                sizeof(config->debounce.eagerStrum),
+            sizeof(config->neck) + sizeof(config->deque));
+    // Older versions only had the leading edge debounce, so keep it
+    config->debounce.eagerButtons = true;
+    config->debounce.eagerStrum = true;
+  }
   if (config->main.version < 7) { config->rf.rfInEnabled = false; }
   // We made a change to simplify the guitar config, but as a result whammy is
   // now flipped
@@ -70,6 +89,15 @@ void loadConfig(Configuration_t *config) {
     config->debounce.strum *= 10;
 
   }
+  if (config->main.version < 20) {
+    memcpy_P(&config->axisFilter, &default_config.axisFilter,
+             sizeof(default_config.axisFilter));
+  }
+  if (config->main.version < 21) {
+    memcpy_P(&config->axisCurve, &default_config.axisCurve,
+             sizeof(default_config.axisCurve));
+  }
+  if (config->main.version < 22) { config->autoCalibrate = 0; }
   
   if (config->main.version < CONFIG_VERSION) {
     config->main.version = CONFIG_VERSION;
@@ -82,6 +110,8 @@ void writeConfigByte(uint16_t offset, uint8_t byte) {
 void writeConfigBlock(uint16_t offset, const uint8_t *data, uint16_t len) {
   eeprom_update_block(data, ((uint8_t *)&config_pointer) + offset, len);
 }
+// eeprom_update_block has already written everything
+void commitConfig(void) {}
 void readConfigBlock(uint16_t offset, uint8_t *data, uint16_t len) {
   eeprom_read_block(data, ((uint8_t *)&config_pointer) + offset, len);
 }
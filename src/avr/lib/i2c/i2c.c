@@ -144,8 +144,8 @@ void twi_disable(void) {
  * Output   number of bytes read
  */
 // === MODIFIED ===
-bool twi_readFrom(uint8_t address, uint8_t *data, uint8_t length,
-                  uint8_t sendStop) {
+static bool twi_read(uint8_t address, uint8_t *data, uint8_t length,
+                     uint8_t sendStop, bool wait) {
 
   // ensure data will fit into buffer
   if (TWI_BUFFER_LENGTH < length) return 0;
@@ -225,6 +225,9 @@ bool twi_readFrom(uint8_t address, uint8_t *data, uint8_t length,
   }
 
   // === MODIFIED ===
+  // the isr fills twi_masterBuffer, and twi_poll collects it
+  if (!wait) return true;
+
   // wait for read operation to complete
   if (TIMEOUT == 0) {
     while (TWI_MRX == twi_state) continue;
@@ -249,6 +252,10 @@ bool twi_readFrom(uint8_t address, uint8_t *data, uint8_t length,
 
   return length;
 }
+bool twi_readFrom(uint8_t address, uint8_t *data, uint8_t length,
+                  uint8_t sendStop) {
+  return twi_read(address, data, length, sendStop, true);
+}
 
 /*
  * Function twi_writeTo
@@ -364,6 +371,35 @@ bool twi_writeTo(uint8_t address, uint8_t *data, uint8_t length, uint8_t wait,
   return twi_error == 0xFF;
 }
 
+// === MODIFIED ===
+// The isr already runs the whole transfer, so starting one is the same as the
+// blocking calls without the wait at the end. They don't wait for the bus
+// either, so a transfer that is still going is an error instead.
+static uint8_t twi_asyncLength;
+bool twi_startWrite(uint8_t address, uint8_t *data, uint8_t length) {
+  if (TWI_READY != twi_state) return false;
+  twi_asyncLength = 0;
+  return twi_writeTo(address, data, length, false, true);
+}
+bool twi_startRead(uint8_t address, uint8_t length) {
+  if (TWI_READY != twi_state) return false;
+  twi_asyncLength = length;
+  return twi_read(address, NULL, length, true, false);
+}
+uint8_t twi_poll(uint8_t *data) {
+  if (TWI_READY != twi_state) return TWI_ASYNC_BUSY;
+  if (!twi_asyncLength) {
+    return twi_error == 0xFF ? TWI_ASYNC_DONE : TWI_ASYNC_FAILED;
+  }
+  // A nack on the address stops the read without setting twi_error
+  if (twi_masterBufferIndex < twi_asyncLength) return TWI_ASYNC_FAILED;
+  memcpy(data, twi_masterBuffer, twi_asyncLength);
+  return TWI_ASYNC_DONE;
+}
+void twi_cancel(void) {
+  if (TWI_READY != twi_state) twi_stop();
+}
+
 /*
  * Function twi_reply
  * Desc     sends byte or readys receive line
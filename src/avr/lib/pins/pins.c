@@ -1,6 +1,7 @@
 #include "pins/pins.h"
 #include "eeprom/eeprom.h"
 #include "stddef.h"
+#include "timer/timer.h"
 #include "util/util.h"
 #include <avr/interrupt.h>
 // On the ATmega1280, the addresses of some of the port registers are
@@ -40,9 +41,7 @@ void setUpDigital(Pin_t *pin, Configuration_t *config, uint8_t pinNum,
     pin->port = portInputRegister(port);
   }
   pin->eq = inverted;
-  pin->milliDeBounce = config->debounce.buttons;
   pin->analogOffset = INVALID_PIN;
-  pin->lastMillis = 0;
 }
 uint32_t countPulseASM(volatile uint8_t *port, uint8_t bit, uint8_t stateMask,
                        unsigned long maxloops);
@@ -105,6 +104,55 @@ void digitalWrite(uint8_t pin, uint8_t val) {
   SREG = oldSREG;
 }
 
+uint8_t pinPort(Pin_t *pin) { return digitalPinToPort(pin->pin); }
+uint8_t pinBit(Pin_t *pin) {
+  uint8_t bit = 0;
+  while (!(pin->mask & _BV(bit))) { bit++; }
+  return bit;
+}
+port_t readPort(uint8_t port) { return *portInputRegister(port); }
+uint8_t digitalPinPort(uint8_t pin) { return digitalPinToPort(pin); }
+port_t digitalPinMask(uint8_t pin) { return digitalPinToBitMask(pin); }
+void pullUpPort(uint8_t port, port_t mask) {
+  volatile uint8_t *reg = portModeRegister(port);
+  volatile uint8_t *out = portOutputRegister(port);
+  uint8_t oldSREG = SREG;
+  cli();
+  *reg &= ~mask;
+  *out |= mask;
+  SREG = oldSREG;
+}
+#ifdef CAPTURE_EDGES
+// Each pin change interrupt covers (at most) one port. The 32u4 only has port
+// B, and on the mega PCINT1 is split across two ports, so it isn't used.
+#  if defined(__AVR_ATmega32U4__)
+static const uint8_t pinChangePorts[] = {PB};
+#  elif defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+static const uint8_t pinChangePorts[] = {PB, NOT_A_PORT, PK};
+#  else
+static const uint8_t pinChangePorts[] = {PB, PC, PD};
+#  endif
+bool enablePinChange(Pin_t *pin) {
+  volatile uint8_t *pcicr = digitalPinToPCICR(pin->pin);
+  if (!pcicr) return false;
+  uint8_t group = digitalPinToPCICRbit(pin->pin);
+  if (group >= sizeof(pinChangePorts) ||
+      pinChangePorts[group] != digitalPinToPort(pin->pin)) {
+    return false;
+  }
+  *digitalPinToPCMSK(pin->pin) |= _BV(digitalPinToPCMSKbit(pin->pin));
+  *pcicr |= _BV(group);
+  return true;
+}
+ISR(PCINT0_vect) { pinChanged(PB, PINB); }
+#  if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+ISR(PCINT2_vect) { pinChanged(PK, PINK); }
+#  elif !defined(__AVR_ATmega32U4__)
+ISR(PCINT1_vect) { pinChanged(PC, PINC); }
+ISR(PCINT2_vect) { pinChanged(PD, PIND); }
+#  endif
+#endif
+
 bool digitalRead(uint8_t pin) {
   uint8_t bit = digitalPinToBitMask(pin);
   uint8_t port = digitalPinToPort(pin);
@@ -150,6 +198,84 @@ void setUpAnalogDigitalPin(Pin_t *button, uint8_t pin, uint16_t threshold) {
   ret.pin = pin;
   joyData[validAnalog++] = ret;
 }
+static inline void selectAnalog(uint8_t pin) {
+#if defined(ADCSRB) && defined(MUX5)
+  // the MUX5 bit of ADCSRB selects whether we're reading from channels
+  // 0 to 7 (MUX5 low) or 8 to 15 (MUX5 high).
+  ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((pin >> 3) & 0x01) << MUX5);
+#endif
+
+  // set the analog reference (high two bits of ADMUX) and select the
+  // channel (low 4 bits).  this also sets ADLAR (left-adjust result)
+  // to 0 (the default).
+
+  ADMUX = (1 << 6) | (pin & 0x07);
+}
+static inline void storeAnalog(AnalogInfo_t *info, int16_t data) {
+  // Drums are compared against their threshold as they are
+  if (!info->hasDigital) {
+    data = data - 512;
+    if (info->inverted) data = -data;
+    data = data * 64;
+  }
+  info->value = data;
+}
+#ifdef ADC_SCAN
+// The ADC complete interrupt works through every channel in joyData on its
+// own, starting the next conversion as soon as the last one is done, so how
+// fresh the analog values are doesn't depend on how long the rest of the tick
+// takes. Each pass is written into the back buffer, and only swapped to the
+// front once it is complete, so tickAnalog always sees a full set from the
+// same pass. The swap is skipped while tickAnalog is reading the front
+// buffer, and the next pass just overwrites the back buffer instead.
+volatile uint16_t adcValues[2][NUM_ANALOG_INPUTS];
+volatile uint8_t adcFront;
+volatile bool adcReady;
+volatile bool adcReading;
+bool adcScanning;
+ISR(ADC_vect) {
+  uint8_t low = ADCL;
+  uint8_t high = ADCH;
+  uint16_t value = (high << 8) | low;
+  adcValues[!adcFront][currentAnalog] = value;
+  if (joyData[currentAnalog].hasDigital) {
+    drumSampled(currentAnalog, value, micros());
+  }
+  if (++currentAnalog == validAnalog) {
+    currentAnalog = 0;
+    if (!adcReading) {
+      adcFront = !adcFront;
+      adcReady = true;
+    }
+  }
+  selectAnalog(joyData[currentAnalog].pin);
+  sbi(ADCSRA, ADSC);
+}
+void startADCScan(void) {
+  currentAnalog = 0;
+  adcReady = false;
+  adcScanning = true;
+  selectAnalog(joyData[0].pin);
+  // Clear anything left over from analogRead before turning the interrupt on
+  sbi(ADCSRA, ADIF);
+  sbi(ADCSRA, ADIE);
+  sbi(ADCSRA, ADSC);
+}
+void tickAnalog(void) {
+  if (validAnalog == 0) return;
+  if (!adcScanning) {
+    startADCScan();
+    return;
+  }
+  if (!adcReady) return;
+  adcReading = true;
+  volatile uint16_t *values = adcValues[adcFront];
+  for (uint8_t i = 0; i < validAnalog; i++) {
+    storeAnalog(&joyData[i], values[i]);
+  }
+  adcReading = false;
+}
+#else
 void tickAnalog(void) {
   if (validAnalog == 0) return;
   if (!first) {
@@ -157,34 +283,15 @@ void tickAnalog(void) {
     uint8_t low, high;
     low = ADCL;
     high = ADCH;
-    int16_t data = (high << 8) | low;
-    AnalogInfo_t *info = &joyData[currentAnalog];
-    if (!info->hasDigital) {
-      data = data - 512;
-      if (info->inverted) data = -data;
-    }
-    data = data * 64;
-    info->value = data;
+    storeAnalog(&joyData[currentAnalog], (high << 8) | low);
     currentAnalog++;
     if (currentAnalog == validAnalog) { currentAnalog = 0; }
   }
   first = false;
-  AnalogInfo_t info = joyData[currentAnalog];
-
-#if defined(ADCSRB) && defined(MUX5)
-  // the MUX5 bit of ADCSRB selects whether we're reading from channels
-  // 0 to 7 (MUX5 low) or 8 to 15 (MUX5 high).
-  ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((info.pin >> 3) & 0x01) << MUX5);
-#endif
-
-  // set the analog reference (high two bits of ADMUX) and select the
-  // channel (low 4 bits).  this also sets ADLAR (left-adjust result)
-  // to 0 (the default).
-
-  ADMUX = (1 << 6) | (info.pin & 0x07);
-
+  selectAnalog(joyData[currentAnalog].pin);
   sbi(ADCSRA, ADSC);
 }
+#endif
 
 uint16_t analogRead(uint8_t pin) {
   uint8_t low, high;
@@ -251,6 +358,11 @@ uint16_t analogRead(uint8_t pin) {
   return (high << 8) | low;
 }
 void stopReading(void) {
+#ifdef ADC_SCAN
+  // The scan is started again by the next tickAnalog
+  cbi(ADCSRA, ADIE);
+  adcScanning = false;
+#endif
   while (bit_is_set(ADCSRA, ADSC))
     ;
   first = true;
@@ -318,8 +430,12 @@ void setupADC(void) {
   // enable a2d conversions
   sbi(ADCSRA, ADEN);
 #endif
-  // Enable adc interrupts
-  // sbi(ADCSRA, ADIE);
+#ifdef ADC_SCAN
+  // Any conversion that was in flight (such as when waking up from sleep) is
+  // gone, so let the next tickAnalog start the scan again
+  cbi(ADCSRA, ADIE);
+  adcScanning = false;
+#endif
 }
 
 void setUpValidPins(Configuration_t *config) {
@@ -18,6 +18,11 @@ SRC += ${PROJECT_ROOT}/src/avr/lib/bootloader/bootloader.c
 LUFA_PATH    = ${PROJECT_ROOT}/lib/lufa/LUFA
 CC_FLAGS     += -DUSE_LUFA_CONFIG_HEADER -I${PROJECT_ROOT}/src/shared/output -I${PROJECT_ROOT}/src/avr/shared -I${PROJECT_ROOT}/src/avr/variants/${VARIANT} -I ${PROJECT_ROOT}/src/shared -I ${PROJECT_ROOT}/src/shared/lib -I${PROJECT_ROOT}/lib -I${PROJECT_ROOT}/src/avr/lib -Werror $(REGS) -DARDUINO=1000  -flto -fuse-linker-plugin -ffast-math
 CC_FLAGS     += -DARDWIINO_BOARD='"${ARDWIINO_BOARD}"' 
+CC_FLAGS     += $(if ${TRACE},-DTRACE_STAGES,)
+CC_FLAGS     += $(if ${RECORD},-DRECORD_INPUTS,)
+CC_FLAGS     += $(if ${CAPTURE},-DCAPTURE_EDGES,)
+CC_FLAGS     += $(if ${SCAN},-DADC_SCAN,)
+CC_FLAGS     += $(if ${BAKED},-DBAKED_CONFIG -I${BAKED},)
 CC_FLAGS 	 += -DSIGNATURE='"${SIGNATURE}"' -DVERSION_MAJOR='${VERSION_MAJOR}' -DVERSION_MINOR='${VERSION_MINOR}' -DVERSION_REVISION='${VERSION_REVISION}' -DMCU='"${MCU}"'
 LD_FLAGS     += $(REGS) -flto -fuse-linker-plugin 
 OBJDIR		 = obj
@@ -9,9 +9,12 @@
 #include "output/control_requests.h"
 #include "output/descriptors.h"
 #include "output/reports.h"
+#include "output/scheduler.h"
 #include "output/serial_handler.h"
 #include "pins/pins.h"
 #include "rf/rf.h"
+#include "stats/stats.h"
+#include "stats/trace.h"
 #include "stdbool.h"
 #include "timer/timer.h"
 #include "usb/usb.h"
@@ -25,19 +28,23 @@ USB_Report_Data_t currentReport;
 uint8_t size;
 bool xinputEnabled = false;
 bool isRF = false;
+#ifndef BAKED_CONFIG
 bool typeIsGuitar;
 bool typeIsDrum;
 bool typeIsDJ;
+#endif
 uint8_t inputType;
 void initialise(void) {
   Configuration_t config;
   loadConfig(&config);
+#ifndef BAKED_CONFIG
   fullDeviceType = config.main.subType;
-  deviceType = fullDeviceType;
-  inputType = config.main.inputType;
   typeIsDrum = isDrum(fullDeviceType);
   typeIsGuitar = isGuitar(fullDeviceType);
   typeIsDJ = isDJ(fullDeviceType);
+#endif
+  deviceType = fullDeviceType;
+  inputType = config.main.inputType;
   if (typeIsGuitar && deviceType <= XINPUT_TURNTABLE) {
     deviceType = REAL_GUITAR_SUBTYPE;
   }
@@ -67,15 +74,21 @@ int main(void) {
   uint8_t cSize = sizeof(XInput_Data_t);
   while (true) {
     USB_USBTask();
+    tickStats();
     if (isRF) {
       tickRFInput((uint8_t *)&controller, cSize);
     } else {
       if (!tickInputs(&controller)) { continue; }
+      statsInputReady();
+      TRACE_BEGIN(TRACE_LEDS);
       tickLEDs(&controller);
+      TRACE_END(TRACE_LEDS);
     }
     if (memcmp(&controller, &prevController, cSize) != 0 &&
         Endpoint_IsINReady()) {
+      TRACE_BEGIN(TRACE_FILL_REPORT);
       fillReport(&currentReport, &size, &controller);
+      TRACE_END(TRACE_FILL_REPORT);
       if (size) {
         uint8_t *data = (uint8_t *)&currentReport;
         uint8_t rid = *data;
@@ -87,6 +100,9 @@ int main(void) {
         memcpy(&prevController, &controller, cSize);
         Endpoint_Write_Stream_LE(data, size, NULL);
         Endpoint_ClearIN();
+        statsReportSent();
+        schedulerReportSent();
+        captureReportSent();
       }
     }
   }
@@ -101,7 +117,9 @@ void EVENT_USB_Device_ConfigurationChanged(void) {
   Endpoint_ConfigureEndpoint(XINPUT_EPADDR_OUT, EP_TYPE_INTERRUPT, HID_EPSIZE,
                              1);
   Endpoint_ConfigureEndpoint(MIDI_EPADDR_OUT, EP_TYPE_INTERRUPT, HID_EPSIZE, 1);
+  USB_Device_EnableSOFEvents();
 }
+void EVENT_USB_Device_StartOfFrame(void) { schedulerStartOfFrame(); }
 void processHIDWriteFeatureReportControl(uint8_t cmd, uint8_t data_len) {
   uint8_t buf[66];
   buf[0] = cmd;
@@ -64,23 +64,27 @@ __attribute__((section(".rfrecv"))) uint32_t rfrxID = 0xDEADBEEF;
 Controller_t controller;
 Controller_t prevCtrl;
 bool isRF = false;
+#ifndef BAKED_CONFIG
 bool typeIsGuitar;
 bool typeIsDrum;
 bool typeIsDJ;
+uint8_t fullDeviceType;
+#endif
 long lastPoll = 0;
 uint8_t inputType;
 uint8_t deviceType;
-uint8_t fullDeviceType;
 void initialise(void) {
   Configuration_t config;
   loadConfig(&config);
   config.rf.rfInEnabled = false;
+#ifndef BAKED_CONFIG
   fullDeviceType = config.main.subType;
-  deviceType = fullDeviceType;
-  inputType = config.main.inputType;
   typeIsDrum = isDrum(fullDeviceType);
   typeIsGuitar = isGuitar(fullDeviceType);
   typeIsDJ = isDJ(fullDeviceType);
+#endif
+  deviceType = fullDeviceType;
+  inputType = config.main.inputType;
   if (typeIsGuitar && deviceType <= XINPUT_TURNTABLE) {
     deviceType = REAL_GUITAR_SUBTYPE;
   }
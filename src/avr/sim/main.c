@@ -0,0 +1,197 @@
+// Runs the pro micro firmware under simavr, and measures how many cycles it
+// takes for a button press to make it into an IN endpoint. This is done for
+// each input type, with a model of the relevant peripheral attached.
+#include "config/config.h"
+#include "config/defaults.h"
+#include "psx.h"
+#include "wii_ext.h"
+#include <avr_eeprom.h>
+#include <avr_ioport.h>
+#include <sim_avr.h>
+#include <sim_elf.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MCU "atmega32u4"
+#define F_CPU 16000000
+// Registers and bits on the 32u4 that LUFA waits on
+#define REG_PLLCSR 0x49
+#define BIT_PLOCK 0
+#define REG_UEINTX 0xE8
+#define BIT_TXINI 0
+#define BIT_RWAL 5
+// D4 (PD4) is bound to A in direct mode
+#define DIRECT_PORT 'D'
+#define DIRECT_BIT 4
+#define DIRECT_PIN 4
+// Give the firmware time to boot and find its controller before measuring
+#define SETTLE_MS 1000
+#define EDGE_INTERVAL_MS 5
+#define EDGE_TIMEOUT_MS 20
+#define DEFAULT_EDGES 64
+
+static const struct {
+  uint8_t type;
+  const char *name;
+} inputTypes[] = {{DIRECT, "direct"}, {WII, "wii"}, {PS2, "ps2"}};
+
+static bool clearedIN;
+static avr_io_read_t oldPLLRead, oldUEINTXRead;
+static void *oldPLLParam, *oldUEINTXParam;
+
+static uint8_t readOld(avr_t *avr, avr_io_addr_t addr, avr_io_read_t read,
+                       void *param) {
+  return read ? read(avr, addr, param) : avr->data[addr];
+}
+static uint8_t pllRead(avr_t *avr, avr_io_addr_t addr, void *param) {
+  return readOld(avr, addr, oldPLLRead, oldPLLParam) | (1 << BIT_PLOCK);
+}
+// There is no host on the other end, so every endpoint is always ready.
+static uint8_t ueintxRead(avr_t *avr, avr_io_addr_t addr, void *param) {
+  return readOld(avr, addr, oldUEINTXRead, oldUEINTXParam) | (1 << BIT_TXINI) |
+         (1 << BIT_RWAL);
+}
+// Endpoint_ClearIN clears TXINI, which is the moment a report is handed over
+static void ueintxWrite(avr_t *avr, avr_io_addr_t addr, uint8_t v,
+                        void *param) {
+  if (!(v & (1 << BIT_TXINI))) clearedIN = true;
+  avr->data[addr] = v;
+}
+
+static void hookRead(avr_t *avr, avr_io_addr_t addr, avr_io_read_t read,
+                     avr_io_read_t *old, void **oldParam) {
+  // simavr refuses to register a second reader, so chain to the existing one
+  avr_io_addr_t a = AVR_DATA_TO_IO(addr);
+  *old = avr->io[a].r.c;
+  *oldParam = avr->io[a].r.param;
+  avr->io[a].r.c = read;
+  avr->io[a].r.param = NULL;
+}
+
+// Overwrite the config stored in the eeprom image, it is found by looking for
+// the signature, as EEMEM placement is up to the linker.
+static bool writeConfig(avr_t *avr, elf_firmware_t *fw, uint8_t input) {
+  Configuration_t config = DEFAULT_CONFIG;
+  config.main.inputType = input;
+  config.main.subType = XINPUT_GAMEPAD;
+  config.pins.a = DIRECT_PIN;
+  uint32_t signature = ARDWIINO_DEVICE_TYPE;
+  size_t sigOffset =
+      offsetof(Configuration_t, main) + offsetof(MainConfig_t, signature);
+  for (uint32_t i = sigOffset; i + sizeof(signature) <= fw->eesize; i++) {
+    if (memcmp(fw->eeprom + i, &signature, sizeof(signature)) == 0) {
+      avr_eeprom_desc_t desc = {.ee = (uint8_t *)&config,
+                                .offset = i - sigOffset,
+                                .size = sizeof(config)};
+      avr_ioctl(avr, AVR_IOCTL_EEPROM_SET, &desc);
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool runUntil(avr_t *avr, avr_cycle_count_t end, bool stopOnIN) {
+  clearedIN = false;
+  while (avr->cycle < end) {
+    int state = avr_run(avr);
+    if (state == cpu_Done || state == cpu_Crashed) return false;
+    if (stopOnIN && clearedIN) return true;
+  }
+  return !stopOnIN;
+}
+
+static int measure(elf_firmware_t *fw, uint8_t input, const char *name,
+                   int edges) {
+  avr_t *avr = avr_make_mcu_by_name(MCU);
+  if (!avr) {
+    fprintf(stderr, "simavr does not support %s\n", MCU);
+    return -1;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, fw);
+  avr->frequency = F_CPU;
+  if (!writeConfig(avr, fw, input)) {
+    fprintf(stderr, "no config found in the eeprom image\n");
+    return -1;
+  }
+  hookRead(avr, REG_PLLCSR, pllRead, &oldPLLRead, &oldPLLParam);
+  hookRead(avr, REG_UEINTX, ueintxRead, &oldUEINTXRead, &oldUEINTXParam);
+  avr_register_io_write(avr, REG_UEINTX, ueintxWrite, NULL);
+  avr_irq_t *button =
+      avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(DIRECT_PORT), DIRECT_BIT);
+  avr_raise_irq(button, 1);
+  static wii_ext_t wii;
+  static psx_t psx;
+  if (input == WII) wii_ext_init(avr, &wii, WII_CLASSIC_CONTROLLER_PRO);
+  if (input == PS2) psx_init(avr, &psx);
+
+  avr_cycle_count_t msCycles = F_CPU / 1000;
+  runUntil(avr, avr->cycle + SETTLE_MS * msCycles, false);
+
+  avr_cycle_count_t min = ~0ULL, max = 0, total = 0;
+  int missed = 0;
+  for (int i = 0; i < edges; i++) {
+    bool pressed = !(i & 1);
+    switch (input) {
+    case DIRECT:
+      avr_raise_irq(button, !pressed);
+      break;
+    case WII:
+      // A on a classic controller is bit 4 of byte 5
+      wii_ext_set_buttons(&wii, pressed ? (1 << 12) : 0);
+      break;
+    case PS2:
+      // Cross is bit 14 of the button word
+      psx_set_buttons(&psx, pressed ? (1 << 14) : 0);
+      break;
+    }
+    avr_cycle_count_t start = avr->cycle;
+    if (runUntil(avr, start + EDGE_TIMEOUT_MS * msCycles, true)) {
+      avr_cycle_count_t taken = avr->cycle - start;
+      if (taken < min) min = taken;
+      if (taken > max) max = taken;
+      total += taken;
+    } else {
+      missed++;
+    }
+    // Stagger the next edge so that it doesn't always land in the same
+    // place in the main loop.
+    runUntil(avr, avr->cycle + EDGE_INTERVAL_MS * msCycles + i * 97, false);
+  }
+  int seen = edges - missed;
+  if (seen) {
+    printf("%-6s %10llu %10llu %10llu %8.1f %8.1f %8.1f %4d\n", name,
+           (unsigned long long)min, (unsigned long long)(total / seen),
+           (unsigned long long)max, min * 1e6 / F_CPU,
+           (total / seen) * 1e6 / F_CPU, max * 1e6 / F_CPU, missed);
+  } else {
+    printf("%-6s no reports seen\n", name);
+  }
+  avr_terminate(avr);
+  return missed;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s firmware.elf [edges]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  int edges = argc > 2 ? atoi(argv[2]) : DEFAULT_EDGES;
+  elf_firmware_t fw = {{0}};
+  if (elf_read_firmware(argv[1], &fw)) {
+    fprintf(stderr, "unable to load %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  printf("%-6s %10s %10s %10s %8s %8s %8s %4s\n", "input", "min cyc",
+         "avg cyc", "max cyc", "min us", "avg us", "max us", "miss");
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(inputTypes) / sizeof(inputTypes[0]); i++) {
+    if (measure(&fw, inputTypes[i].type, inputTypes[i].name, edges)) {
+      failures++;
+    }
+  }
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#include "psx.h"
+#include <avr_ioport.h>
+#include <avr_spi.h>
+#include <sim_irq.h>
+#include <sim_time.h>
+#include <string.h>
+#define PSX_ID_DUALSHOCK 0x73
+#define PSX_ID_CONFIG 0xF3
+// Attention is D10 (PB6) and acknowledge is D7 (PE6 / INT6)
+#define ATT_PORT 'B'
+#define ATT_BIT 6
+#define ACK_PORT 'E'
+#define ACK_BIT 6
+// A real controller pulls ack low for a few microseconds after each byte
+#define ACK_DELAY_US 8
+#define ACK_WIDTH_US 3
+
+enum { PSX_IRQ_SPI_OUT, PSX_IRQ_SPI_IN, PSX_IRQ_ATT, PSX_IRQ_COUNT };
+
+static avr_cycle_count_t psx_ack_release(avr_t *avr, avr_cycle_count_t when,
+                                         void *param) {
+  psx_t *p = (psx_t *)param;
+  avr_raise_irq(p->ack, 1);
+  return 0;
+}
+static avr_cycle_count_t psx_ack_start(avr_t *avr, avr_cycle_count_t when,
+                                       void *param) {
+  psx_t *p = (psx_t *)param;
+  avr_raise_irq(p->ack, 0);
+  avr_cycle_timer_register_usec(avr, ACK_WIDTH_US, psx_ack_release, p);
+  return 0;
+}
+
+static void psx_spi_hook(struct avr_irq_t *irq, uint32_t value, void *param) {
+  psx_t *p = (psx_t *)param;
+  if (!p->selected) return;
+  // simavr hands over bytes as they were written to SPDR, so the bit order
+  // (DORD) the firmware uses makes no difference here.
+  uint8_t data = value;
+  uint8_t resp = 0xFF;
+  switch (p->index) {
+  case 0:
+    break;
+  case 1:
+    p->cmd = data;
+    resp = p->config_mode ? PSX_ID_CONFIG : PSX_ID_DUALSHOCK;
+    break;
+  case 2:
+    resp = 0x5A;
+    break;
+  default:
+    if (p->index == 3) p->arg = data;
+    if (p->index - 3 < (int)sizeof(p->reply)) resp = p->reply[p->index - 3];
+    break;
+  }
+  p->index++;
+  avr_raise_irq(p->irq + PSX_IRQ_SPI_IN, resp);
+  avr_cycle_timer_register_usec(p->avr, ACK_DELAY_US, psx_ack_start, p);
+}
+
+static void psx_att_hook(struct avr_irq_t *irq, uint32_t value, void *param) {
+  psx_t *p = (psx_t *)param;
+  bool active = !value;
+  if (active && !p->selected) p->index = 0;
+  if (!active && p->selected && p->cmd == 0x43 && p->index > 3) {
+    p->config_mode = p->arg == 0x01;
+  }
+  p->selected = active;
+}
+
+void psx_init(avr_t *avr, psx_t *p) {
+  static const char *names[] = {"8>psx.spi.out", "8<psx.spi.in", "1>psx.att"};
+  memset(p, 0, sizeof(*p));
+  p->avr = avr;
+  p->irq = avr_alloc_irq(&avr->irq_pool, 0, PSX_IRQ_COUNT, names);
+  avr_irq_register_notify(p->irq + PSX_IRQ_SPI_OUT, psx_spi_hook, p);
+  avr_irq_register_notify(p->irq + PSX_IRQ_ATT, psx_att_hook, p);
+  avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_OUTPUT),
+                  p->irq + PSX_IRQ_SPI_OUT);
+  avr_connect_irq(p->irq + PSX_IRQ_SPI_IN,
+                  avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_INPUT));
+  avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(ATT_PORT), ATT_BIT),
+                  p->irq + PSX_IRQ_ATT);
+  p->ack = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(ACK_PORT), ACK_BIT);
+  avr_raise_irq(p->ack, 1);
+  psx_set_buttons(p, 0);
+  p->reply[2] = p->reply[3] = p->reply[4] = p->reply[5] = 0x80;
+}
+
+void psx_set_buttons(psx_t *p, uint16_t buttons) {
+  buttons = ~buttons;
+  p->reply[0] = buttons & 0xFF;
+  p->reply[1] = buttons >> 8;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <sim_avr.h>
+#include <stdbool.h>
+#include <stdint.h>
+// A DualShock (analog mode) on the SPI bus. Attention and acknowledge are
+// wired to the same pins as the firmware expects on a pro micro.
+typedef struct {
+  avr_irq_t *irq;
+  avr_t *avr;
+  avr_irq_t *ack;
+  bool selected;
+  bool config_mode;
+  uint8_t index;
+  uint8_t cmd;
+  uint8_t arg;
+  uint8_t reply[6];
+} psx_t;
+void psx_init(avr_t *avr, psx_t *p);
+void psx_set_buttons(psx_t *p, uint16_t buttons);
@@ -0,0 +1,68 @@
+#include "wii_ext.h"
+#include <avr_twi.h>
+#include <sim_irq.h>
+#include <string.h>
+#define WII_ADDR 0x52
+
+static void wii_ext_twi_hook(struct avr_irq_t *irq, uint32_t value,
+                             void *param) {
+  wii_ext_t *p = (wii_ext_t *)param;
+  avr_twi_msg_irq_t v;
+  v.u.v = value;
+  if (v.u.twi.msg & TWI_COND_STOP) {
+    p->selected = 0;
+    p->index = 0;
+  }
+  if (v.u.twi.msg & TWI_COND_START) {
+    p->selected = 0;
+    p->index = 0;
+    if ((v.u.twi.addr >> 1) == WII_ADDR) {
+      p->selected = v.u.twi.addr;
+      avr_raise_irq(p->irq + TWI_IRQ_INPUT,
+                    avr_twi_irq_msg(TWI_COND_ACK, p->selected, 1));
+    }
+  }
+  if (!p->selected) return;
+  if (v.u.twi.msg & TWI_COND_WRITE) {
+    avr_raise_irq(p->irq + TWI_IRQ_INPUT,
+                  avr_twi_irq_msg(TWI_COND_ACK, p->selected, 1));
+    // Unlike an eeprom, the pointer is kept across transactions, as the
+    // firmware sets it in one transaction and reads in another.
+    if (p->index++ == 0) {
+      p->pointer = v.u.twi.data;
+    } else {
+      p->regs[p->pointer++] = v.u.twi.data;
+    }
+  }
+  if (v.u.twi.msg & TWI_COND_READ) {
+    avr_raise_irq(p->irq + TWI_IRQ_INPUT,
+                  avr_twi_irq_msg(TWI_COND_READ, p->selected,
+                                  p->regs[p->pointer++]));
+  }
+}
+
+void wii_ext_init(avr_t *avr, wii_ext_t *p, uint16_t id) {
+  static const char *names[] = {"8>wii.out", "32<wii.in"};
+  memset(p, 0, sizeof(*p));
+  p->avr = avr;
+  p->irq = avr_alloc_irq(&avr->irq_pool, 0, 2, names);
+  avr_irq_register_notify(p->irq + TWI_IRQ_OUTPUT, wii_ext_twi_hook, p);
+  avr_connect_irq(p->irq + TWI_IRQ_INPUT,
+                  avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+  avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT),
+                  p->irq + TWI_IRQ_OUTPUT);
+  p->regs[0xFA] = id >> 8;
+  p->regs[0xFC] = 0xA4;
+  p->regs[0xFD] = 0x20;
+  p->regs[0xFE] = 0x01;
+  p->regs[0xFF] = id & 0xFF;
+  // Centered sticks and triggers, nothing pressed
+  static const uint8_t neutral[] = {0x20, 0x20, 0x10, 0x10, 0xFF, 0xFF};
+  memcpy(p->regs, neutral, sizeof(neutral));
+}
+
+void wii_ext_set_buttons(wii_ext_t *p, uint16_t buttons) {
+  // Buttons are active low, in bytes 4 and 5 of a standard report
+  p->regs[4] = ~(buttons & 0xFF);
+  p->regs[5] = ~(buttons >> 8);
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <sim_avr.h>
+#include <stdint.h>
+// A wii extension on the TWI bus. It behaves like a 256 byte register file,
+// with the id at 0xFA and the controller data at 0x00.
+typedef struct {
+  avr_irq_t *irq;
+  avr_t *avr;
+  uint8_t selected;
+  uint8_t index;
+  uint8_t pointer;
+  uint8_t regs[256];
+} wii_ext_t;
+void wii_ext_init(avr_t *avr, wii_ext_t *p, uint16_t id);
+void wii_ext_set_buttons(wii_ext_t *p, uint16_t buttons);
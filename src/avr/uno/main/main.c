@@ -12,6 +12,8 @@
 #include "pins/pins.h"
 #include "pins_arduino.h"
 #include "rf/rf.h"
+#include "stats/stats.h"
+#include "stats/trace.h"
 #include "timer/timer.h"
 #include "util/util.h"
 #include <LUFA/Drivers/Misc/RingBuffer.h>
@@ -34,10 +36,12 @@ bool readyForPacket = true;
 long lastPoll = 0;
 bool isRF = false;
 uint8_t deviceType;
+#ifndef BAKED_CONFIG
 uint8_t fullDeviceType;
 bool typeIsGuitar;
 bool typeIsDrum;
 bool typeIsDJ;
+#endif
 uint8_t inputType;
 static inline void Serial_InitInterrupt(const uint32_t BaudRate,
                                         const bool DoubleSpeed) {
@@ -59,12 +63,14 @@ void writeData(const uint8_t *buf, uint8_t len) {
 void initialise(void) {
   Configuration_t config;
   loadConfig(&config);
+#ifndef BAKED_CONFIG
   fullDeviceType = config.main.subType;
-  deviceType = fullDeviceType;
-  inputType = config.main.inputType;
   typeIsDrum = isDrum(fullDeviceType);
   typeIsGuitar = isGuitar(fullDeviceType);
   typeIsDJ = isDJ(fullDeviceType);
+#endif
+  deviceType = fullDeviceType;
+  inputType = config.main.inputType;
   setupMicrosTimer();
   if (config.rf.rfInEnabled) {
     initRF(false, config.rf.id, generate_crc32());
@@ -89,6 +95,7 @@ int main(void) {
   uint16_t offset;
   uint8_t origOffset;
   while (true) {
+    tickStats();
     //================================================================================
     // USARTtoUSB
     //================================================================================
@@ -197,18 +204,25 @@ int main(void) {
         if (!tickInputs(&controller)) {
           continue;
         }
+        statsInputReady();
+        TRACE_BEGIN(TRACE_LEDS);
         tickLEDs(&controller);
+        TRACE_END(TRACE_LEDS);
       }
       uint8_t size;
       if (memcmp(&prevController, &controller, sizeof(XInput_Data_t)) != 0 &&
           readyForPacket) {
+        TRACE_BEGIN(TRACE_FILL_REPORT);
         fillReport(currentReport, &size, &controller);
+        TRACE_END(TRACE_FILL_REPORT);
         lastPoll = millis();
         readyForPacket = false;
         uint8_t done = FRAME_START_WRITE;
         writeData(&done, 1);
         writeData(&size, 1);
         writeData(currentReport, size);
+        statsReportSent();
+        captureReportSent();
         memcpy(&prevController, &controller, sizeof(XInput_Data_t));
       }
     }
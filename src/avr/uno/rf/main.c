@@ -28,11 +28,13 @@ Controller_t controller;
 Controller_t prevCtrl;
 long lastPoll = 0;
 bool isRF = false;
+#ifndef BAKED_CONFIG
 bool typeIsGuitar;
 bool typeIsDrum;
 bool typeIsDJ;
-uint8_t deviceType;
 uint8_t fullDeviceType;
+#endif
+uint8_t deviceType;
 uint8_t inputType;
 __attribute__((section(".rfrecv"))) uint32_t rftxID = 0xDEADBEEF;
 __attribute__((section(".rfrecv"))) uint32_t rfrxID = 0xDEADBEEF;
@@ -40,12 +42,14 @@ void initialise(void) {
   Configuration_t config;
   loadConfig(&config);
   config.rf.rfInEnabled = false;
+#ifndef BAKED_CONFIG
   fullDeviceType = config.main.subType;
-  deviceType = fullDeviceType;
-  inputType = config.main.inputType;
   typeIsDrum = isDrum(fullDeviceType);
   typeIsGuitar = isGuitar(fullDeviceType);
   typeIsDJ = isDJ(fullDeviceType);
+#endif
+  deviceType = fullDeviceType;
+  inputType = config.main.inputType;
   if (typeIsGuitar && deviceType <= XINPUT_TURNTABLE) {
     deviceType = REAL_GUITAR_SUBTYPE;
   }
@@ -0,0 +1,116 @@
+// Generates the baked_config.h that a BAKED_CONFIG build is compiled against,
+// from either a raw config (the bytes loadConfig reads, as pulled from the
+// eeprom or flash of a configured controller) or a recording made with
+// scripts/record.py, which starts with the config it was recorded with.
+//
+// Anything the firmware would normally work out from the config during init,
+// and that is worth turning into a constant, is written out alongside the raw
+// bytes. The ps3 bindings come from running the real initPS3 against the
+// config, so that they can't drift from what an unbaked build would use.
+#include "config/defines.h"
+#include "controller/guitar_includes.h"
+#include "eeprom/eeprom.h"
+#include "output/reports/ps3.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Must match scripts/record.py
+#define RECORDING_MAGIC "ARDWREC1"
+
+// ps3.h expects these from the rest of the firmware
+uint8_t fullDeviceType;
+uint8_t drumVelocity[8];
+
+static bool load(const char *path, Configuration_t *config) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  uint8_t buf[sizeof(Configuration_t) + sizeof(RECORDING_MAGIC) + 2];
+  size_t len = fread(buf, 1, sizeof(buf), f);
+  fclose(f);
+  size_t magic = strlen(RECORDING_MAGIC);
+  const uint8_t *data = buf;
+  if (len >= magic + 2 && !memcmp(buf, RECORDING_MAGIC, magic)) {
+    uint16_t configLen = buf[magic] | buf[magic + 1] << 8;
+    if (configLen != sizeof(Configuration_t)) {
+      fprintf(stderr,
+              "%s was recorded with a different config version (%u bytes, "
+              "expected %zu)\n",
+              path, configLen, sizeof(Configuration_t));
+      return false;
+    }
+    data += magic + 2;
+    len -= magic + 2;
+  }
+  if (len < sizeof(Configuration_t)) {
+    fprintf(stderr, "%s is too short to be a config (%zu bytes, expected %zu)\n",
+            path, len, sizeof(Configuration_t));
+    return false;
+  }
+  memcpy(config, data, sizeof(Configuration_t));
+  if (config->main.signature != ARDWIINO_DEVICE_TYPE) {
+    fprintf(stderr, "%s is not an ardwiino config\n", path);
+    return false;
+  }
+  // Older configs are only migrated by the platform loadConfig, so they need
+  // to be loaded into a current firmware and read back first.
+  if (config->main.version != CONFIG_VERSION) {
+    fprintf(stderr, "%s is config version %u, expected %u\n", path,
+            config->main.version, CONFIG_VERSION);
+    return false;
+  }
+  return true;
+}
+
+static void writeBytes(FILE *out, const char *name, const uint8_t *data,
+                       size_t len) {
+  fprintf(out, "#define %s", name);
+  for (size_t i = 0; i < len; i++) {
+    fprintf(out, "%s0x%02x%s", i % 12 ? " " : " \\\n    ", data[i],
+            i + 1 < len ? "," : "");
+  }
+  fprintf(out, "\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s config|recording baked_config.h\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  Configuration_t config;
+  if (!load(argv[1], &config)) return EXIT_FAILURE;
+  FILE *out = fopen(argv[2], "w");
+  if (!out) {
+    perror(argv[2]);
+    return EXIT_FAILURE;
+  }
+  fullDeviceType = config.main.subType;
+  initPS3();
+  fprintf(out, "// Generated by ardwiino_bake from %s, do not edit.\n", argv[1]);
+  fprintf(out, "#pragma once\n");
+  fprintf(out, "#define BAKED_INPUT_TYPE %u\n", config.main.inputType);
+  fprintf(out, "#define BAKED_SUB_TYPE %u\n", config.main.subType);
+  fprintf(out, "#define BAKED_TYPE_IS_GUITAR %u\n", isGuitar(fullDeviceType));
+  fprintf(out, "#define BAKED_TYPE_IS_DRUM %u\n", isDrum(fullDeviceType));
+  fprintf(out, "#define BAKED_TYPE_IS_DJ %u\n", isDJ(fullDeviceType));
+  fprintf(out, "#define BAKED_TILT_TYPE %u\n", config.main.tiltType);
+  writeBytes(out, "BAKED_PS3_BUTTON_BINDINGS", ps3ButtonBindings,
+             sizeof(ps3ButtonBindings));
+  const AxisScale_t *scales = (const AxisScale_t *)&config.axisScale;
+  fprintf(out, "#define BAKED_AXIS_SCALES");
+  for (size_t i = 0; i < sizeof(config.axisScale) / sizeof(AxisScale_t); i++) {
+    fprintf(out, "%s \\\n    {%d, %d, %d}", i ? "," : "",
+            scales[i].multiplier, scales[i].offset, scales[i].deadzone);
+  }
+  fprintf(out, "\n");
+  writeBytes(out, "BAKED_CONFIG_BYTES", (const uint8_t *)&config,
+             sizeof(config));
+  if (fclose(out)) {
+    perror(argv[2]);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
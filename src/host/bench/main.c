@@ -0,0 +1,389 @@
+// Measures the per-tick cost of the shared input and report code on the host.
+// Every input type is run against every output sub type, each in a forked
+// child so that the state kept in the input headers starts fresh every time.
+// After that, every wii extension decoder is checked against the hand written
+// one it replaced and both are timed on the same frames, and the same is done
+// for the arctangents used for tilt. Built with CAPTURE_EDGES, it also checks
+// that a tap between ticks survives the endpoint being busy.
+#define _GNU_SOURCE
+#include "config/defines.h"
+#include "controller/guitar_includes.h"
+#include "eeprom/eeprom.h"
+#include "fxpt_math/fxpt_math.h"
+#include "host.h"
+#include "input/input_handler.h"
+#include "leds/leds.h"
+#include "output/reports.h"
+#include "output/serial_handler.h"
+#include "pins/pins.h"
+#include "timer/timer.h"
+#include "wii_decoders.h"
+#include <linux/perf_event.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WARMUP_TICKS 2000
+#define BENCH_TICKS 20000
+// Simulated time between two calls to tickInputs
+#define TICK_INTERVAL_US 1000
+// Random frames each wii decoder is given, and how many times over
+#define DECODER_FRAMES 4096
+#define DECODER_PASSES 64
+// Vectors each arctangent is given, and how many times over
+#define ATAN2_SAMPLES 4096
+#define ATAN2_PASSES 64
+// The most fxpt_atan2_fast is allowed to be out by, in 1/65536ths of a turn
+#define ATAN2_FAST_MAX_ERROR 2.0
+
+static const struct {
+  uint8_t type;
+  const char *name;
+} inputTypes[] = {{DIRECT, "direct"}, {WII, "wii"}, {PS2, "ps2"}};
+
+// Digital pins used for the 16 buttons in direct mode, skipping i2c and spi
+static const uint8_t directPins[XBOX_BTN_COUNT] = {
+    0, 1, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 18, 19, 20, 21};
+
+static uint32_t rngState = 0x12345678;
+static uint32_t rng(void) {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+static int perfFd = -1;
+static void openInstructionCounter(void) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  perfFd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (perfFd >= 0) { ioctl(perfFd, PERF_EVENT_IOC_ENABLE, 0); }
+}
+static uint64_t readInstructions(void) {
+  uint64_t count = 0;
+  if (perfFd < 0 || read(perfFd, &count, sizeof(count)) != sizeof(count)) {
+    return 0;
+  }
+  return count;
+}
+static uint64_t nowNanos(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint16_t wiiExtensionFor(uint8_t subType) {
+  if (isGuitar(subType)) return WII_GUITAR_HERO_GUITAR_CONTROLLER;
+  if (isDrum(subType)) return WII_GUITAR_HERO_DRUM_CONTROLLER;
+  if (isDJ(subType)) return WII_DJ_HERO_TURNTABLE;
+  return WII_CLASSIC_CONTROLLER_PRO;
+}
+
+static void setUpConfig(Configuration_t *config, uint8_t input,
+                        uint8_t subType) {
+  const Configuration_t def = DEFAULT_CONFIG;
+  *config = def;
+  config->main.inputType = input;
+  config->main.subType = subType;
+  PinsCombined_t *pins = (PinsCombined_t *)&config->pins;
+  if (input == DIRECT) {
+    memcpy(pins->buttons, directPins, sizeof(directPins));
+    for (int i = 2; i < XBOX_AXIS_COUNT; i++) {
+      pins->axis[i].pin = PIN_A0 + i - 2;
+    }
+  }
+  AxisScale_t *scales = (AxisScale_t *)&config->axisScale;
+  for (int i = 0; i < XBOX_AXIS_COUNT; i++) {
+    scales[i].multiplier = 1024;
+    scales[i].deadzone = 1024;
+  }
+}
+
+// Move every input a little, so that the code paths that only run on a
+// change get exercised.
+static void stimulate(uint8_t input) {
+  uint32_t r = rng();
+  switch (input) {
+  case DIRECT: {
+    uint8_t pin = directPins[r % XBOX_BTN_COUNT];
+    hostSetPin(pin, !hostPinLevels[pin]);
+    hostAnalogLevels[(r >> 8) % 4] = (r >> 12) & 0x3FF;
+    break;
+  }
+  case WII: {
+    uint8_t data[8] = {0x20 | (r & 0x1F), 0x20, 0x10, 0x10,
+                       0x00,              0x00, 0x80, 0x80};
+    data[4] = ~(r >> 8);
+    data[5] = ~(r >> 16);
+    hostWiiSetData(0, data, sizeof(data));
+    break;
+  }
+  case PS2:
+    hostPS2SetButtons(r >> 16);
+    hostPS2SetSticks(r, r >> 8, r >> 4, r >> 12);
+    break;
+  }
+  uint8_t platters[3] = {0x80 | (r & 0x0F), 0x00, 0x00};
+  hostI2CSetRegisters(0x0E, 0x12, platters, sizeof(platters));
+  hostI2CSetRegisters(0x0D, 0x12, platters, sizeof(platters));
+}
+
+static void run(uint8_t input, const char *inputName, uint8_t subType,
+                const char *subTypeName) {
+  Configuration_t config;
+  setUpConfig(&config, input, subType);
+  if (input == WII) { hostWiiSetExtension(wiiExtensionFor(subType)); }
+  if (input == PS2) { hostPS2SetGuitar(isGuitar(subType)); }
+  hostInitialise(&config);
+  openInstructionCounter();
+  USB_Report_Data_t report;
+  uint8_t size;
+  uint64_t tickNanos = 0, tickInstr = 0, fillNanos = 0, fillInstr = 0;
+  uint32_t reports = 0;
+  uint64_t busyStart = 0;
+  for (uint32_t i = 0; i < WARMUP_TICKS + BENCH_TICKS; i++) {
+    if (i == WARMUP_TICKS) { busyStart = hostBusyWaitMicros(); }
+    bool measure = i >= WARMUP_TICKS;
+    // Leave the inputs alone for the first tick, as that is where the PS2
+    // code works out what type of controller is attached.
+    if (i) { stimulate(input); }
+    hostAdvanceMicros(TICK_INTERVAL_US);
+    uint64_t startInstr = readInstructions();
+    uint64_t start = nowNanos();
+    bool ready = tickInputs(&controller);
+    uint64_t end = nowNanos();
+    uint64_t endInstr = readInstructions();
+    if (measure) {
+      tickNanos += end - start;
+      tickInstr += endInstr - startInstr;
+    }
+    if (!ready) continue;
+    tickLEDs(&controller);
+    startInstr = readInstructions();
+    start = nowNanos();
+    fillReport(&report, &size, &controller);
+    end = nowNanos();
+    endInstr = readInstructions();
+    captureReportSent();
+    if (measure) {
+      fillNanos += end - start;
+      fillInstr += endInstr - startInstr;
+      reports++;
+    }
+  }
+  double busy = (double)(hostBusyWaitMicros() - busyStart) / BENCH_TICKS;
+  printf("%-6s %-28s %9.1f", inputName, subTypeName,
+         (double)tickNanos / BENCH_TICKS);
+  if (perfFd >= 0) {
+    printf(" %9.1f", (double)tickInstr / BENCH_TICKS);
+  } else {
+    printf(" %9s", "n/a");
+  }
+  printf(" %9.1f", reports ? (double)fillNanos / reports : 0.0);
+  if (perfFd >= 0) {
+    printf(" %9.1f", reports ? (double)fillInstr / reports : 0.0);
+  } else {
+    printf(" %9s", "n/a");
+  }
+  printf(" %9.1f\n", busy);
+}
+
+static const struct {
+  const char *name;
+  void (*decode)(Controller_t *, uint8_t *);
+  void (*reference)(Controller_t *, uint8_t *);
+} decoders[] = {
+    {"guitar", readGuitarExt, referenceReadGuitarExt},
+    {"drum", readDrumExt, referenceReadDrumExt},
+    {"classic", readClassicExt, referenceReadClassicExt},
+    {"classic high res", readClassicExtHighRes,
+     referenceReadClassicExtHighRes},
+    {"nunchuk", readNunchukExt, referenceReadNunchukExt},
+    {"dj", readDJExt, referenceReadDJExt},
+    {"udraw", readUDrawExt, referenceReadUDrawExt},
+    {"drawsome", readDrawsomeExt, referenceReadDrawsomeExt},
+    {"tatacon", readTataconExt, referenceReadTataconExt}};
+
+typedef struct {
+  Controller_t controller;
+  uint16_t buttons;
+  uint8_t drumVelocity[sizeof(drumVelocity)];
+} DecoderOutput_t;
+static void decode(void (*fn)(Controller_t *, uint8_t *), uint8_t *data,
+                   DecoderOutput_t *out) {
+  memset(out, 0, sizeof(DecoderOutput_t));
+  memset(drumVelocity, 0, sizeof(drumVelocity));
+  buttons = 0;
+  fn(&out->controller, data);
+  out->buttons = buttons;
+  memcpy(out->drumVelocity, drumVelocity, sizeof(drumVelocity));
+}
+static uint64_t timeDecoder(void (*fn)(Controller_t *, uint8_t *),
+                            uint8_t (*frames)[8]) {
+  Controller_t out;
+  uint64_t start = nowNanos();
+  for (int pass = 0; pass < DECODER_PASSES; pass++) {
+    for (int i = 0; i < DECODER_FRAMES; i++) { fn(&out, frames[i]); }
+  }
+  return nowNanos() - start;
+}
+// Returns the number of frames that didn't decode the same as the reference
+static int benchDecoders(void) {
+  static uint8_t frames[DECODER_FRAMES][8];
+  for (int i = 0; i < DECODER_FRAMES; i++) {
+    uint32_t r = rng();
+    memcpy(frames[i], &r, 4);
+    r = rng();
+    memcpy(frames[i] + 4, &r, 4);
+  }
+  // Take every optional path through the decoders
+  guitarTapBar = true;
+  mapNunchukAccelToRightJoy = true;
+  fullDeviceType = MIDI_GAMEPAD;
+  printf("\n%-23s %9s %9s %9s\n", "wii decoder", "table ns", "hand ns",
+         "mismatch");
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(decoders) / sizeof(decoders[0]); i++) {
+    int mismatched = 0;
+    for (int j = 0; j < DECODER_FRAMES; j++) {
+      DecoderOutput_t table, hand;
+      decode(decoders[i].decode, frames[j], &table);
+      decode(decoders[i].reference, frames[j], &hand);
+      if (memcmp(&table, &hand, sizeof(table))) { mismatched++; }
+    }
+    double per = DECODER_FRAMES * DECODER_PASSES;
+    printf("%-23s %9.2f %9.2f %9d\n", decoders[i].name,
+           timeDecoder(decoders[i].decode, frames) / per,
+           timeDecoder(decoders[i].reference, frames) / per, mismatched);
+    failures += mismatched;
+  }
+  return failures;
+}
+
+static uint16_t libmAtan2(const int16_t y, const int16_t x) {
+  return lrint(atan2(y, x) * (32768 / M_PI));
+}
+static const struct {
+  const char *name;
+  uint16_t (*atan2)(const int16_t, const int16_t);
+  double maxError;
+} arctangents[] = {{"fxpt_atan2", fxpt_atan2, 0},
+                   {"fxpt_atan2_fast", fxpt_atan2_fast, ATAN2_FAST_MAX_ERROR},
+                   {"atan2 (libm)", libmAtan2, 0}};
+// Returns the number of arctangents that were out by more than they should be
+static int benchAtan2(void) {
+  static int16_t ys[ATAN2_SAMPLES], xs[ATAN2_SAMPLES];
+  for (int i = 0; i < ATAN2_SAMPLES; i++) {
+    uint32_t r = rng();
+    ys[i] = r;
+    xs[i] = r >> 16;
+    // Half of them in the range a nunchuk accelerometer gives
+    if (i & 1) {
+      ys[i] >>= 6;
+      xs[i] >>= 6;
+    }
+  }
+  printf("\n%-23s %9s %9s\n", "arctangent", "ns", "max err");
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(arctangents) / sizeof(arctangents[0]); i++) {
+    // Out by, in 1/65536ths of a turn, going the short way round
+    double maxError = 0;
+    for (int j = 0; j < ATAN2_SAMPLES; j++) {
+      if (!xs[j] && !ys[j]) continue;
+      double exact = atan2(ys[j], xs[j]) * (32768 / M_PI);
+      double error = fabs(remainder(arctangents[i].atan2(ys[j], xs[j]) - exact,
+                                    65536));
+      if (error > maxError) { maxError = error; }
+    }
+    volatile uint16_t sink = 0;
+    uint64_t start = nowNanos();
+    for (int pass = 0; pass < ATAN2_PASSES; pass++) {
+      for (int j = 0; j < ATAN2_SAMPLES; j++) {
+        sink += arctangents[i].atan2(ys[j], xs[j]);
+      }
+    }
+    uint64_t elapsed = nowNanos() - start;
+    printf("%-23s %9.2f %9.2f\n", arctangents[i].name,
+           (double)elapsed / (ATAN2_SAMPLES * ATAN2_PASSES), maxError);
+    if (arctangents[i].maxError && maxError > arctangents[i].maxError) {
+      failures++;
+    }
+  }
+  return failures;
+}
+
+#ifdef CAPTURE_EDGES
+// Taps a direct button between two ticks, and then leaves the endpoint busy
+// for the tick that picked it up. Returns 1 if the tap is gone by the time a
+// report can be sent, or is still held after that.
+static int checkCapture(void) {
+  Configuration_t config;
+  setUpConfig(&config, DIRECT, XINPUT_GAMEPAD);
+  config.main.pollRate = 1;
+  for (int i = 0; i < XBOX_BTN_COUNT; i++) { hostPinLevels[directPins[i]] = 1; }
+  hostInitialise(&config);
+  uint8_t pin = directPins[XBOX_A];
+  hostAdvanceMicros(TICK_INTERVAL_US);
+  tickInputs(&controller);
+  captureReportSent();
+  hostAdvanceMicros(TICK_INTERVAL_US / 4);
+  hostSetPin(pin, 0);
+  hostAdvanceMicros(TICK_INTERVAL_US / 4);
+  hostSetPin(pin, 1);
+  hostAdvanceMicros(TICK_INTERVAL_US / 2);
+  // The endpoint is busy, so nothing is sent
+  tickInputs(&controller);
+  hostAdvanceMicros(TICK_INTERVAL_US);
+  bool ready = tickInputs(&controller);
+  bool held = bit_check(controller.buttons, XBOX_A);
+  captureReportSent();
+  hostAdvanceMicros(TICK_INTERVAL_US);
+  tickInputs(&controller);
+  bool released = !bit_check(controller.buttons, XBOX_A);
+  bool ok = ready && held && released;
+  printf("\ncapture: tap while busy %s\n", ok ? "reported" : "lost");
+  return !ok;
+}
+#endif
+
+int main(int argc, char **argv) {
+  printf("%-6s %-28s %9s %9s %9s %9s %9s\n", "input", "subtype", "tick ns",
+         "tick ins", "fill ns", "fill ins", "busy us");
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(inputTypes) / sizeof(inputTypes[0]); i++) {
+    for (size_t j = 0; j < hostSubTypeCount; j++) {
+      fflush(stdout);
+      pid_t pid = fork();
+      if (pid == 0) {
+        run(inputTypes[i].type, inputTypes[i].name, hostSubTypes[j].type,
+            hostSubTypes[j].name);
+        fflush(stdout);
+        _exit(0);
+      }
+      int status;
+      waitpid(pid, &status, 0);
+      if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+        printf("%-6s %-28s failed\n", inputTypes[i].name, hostSubTypes[j].name);
+        failures++;
+      }
+    }
+  }
+#ifdef CAPTURE_EDGES
+  failures += checkCapture();
+#endif
+  failures += benchDecoders();
+  failures += benchAtan2();
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,34 @@
+#pragma once
+// The wii extension decoders from wii_ext.h, along with the hand written ones
+// that the layouts in wii_layouts.h replaced, so that the two can be checked
+// against each other and timed on the same frames.
+#include "controller/controller.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// State from wii_ext.h (and direct.h) that the decoders read or write
+extern uint16_t buttons;
+extern bool guitarTapBar;
+extern bool mapNunchukAccelToRightJoy;
+extern uint8_t drumVelocity[8];
+extern const uint8_t wiiButtonBindings[XBOX_BTN_COUNT];
+
+void readGuitarExt(Controller_t *controller, uint8_t *data);
+void readDrumExt(Controller_t *controller, uint8_t *data);
+void readClassicExt(Controller_t *controller, uint8_t *data);
+void readClassicExtHighRes(Controller_t *controller, uint8_t *data);
+void readNunchukExt(Controller_t *controller, uint8_t *data);
+void readDJExt(Controller_t *controller, uint8_t *data);
+void readUDrawExt(Controller_t *controller, uint8_t *data);
+void readDrawsomeExt(Controller_t *controller, uint8_t *data);
+void readTataconExt(Controller_t *controller, uint8_t *data);
+
+void referenceReadGuitarExt(Controller_t *controller, uint8_t *data);
+void referenceReadDrumExt(Controller_t *controller, uint8_t *data);
+void referenceReadClassicExt(Controller_t *controller, uint8_t *data);
+void referenceReadClassicExtHighRes(Controller_t *controller, uint8_t *data);
+void referenceReadNunchukExt(Controller_t *controller, uint8_t *data);
+void referenceReadDJExt(Controller_t *controller, uint8_t *data);
+void referenceReadUDrawExt(Controller_t *controller, uint8_t *data);
+void referenceReadDrawsomeExt(Controller_t *controller, uint8_t *data);
+void referenceReadTataconExt(Controller_t *controller, uint8_t *data);
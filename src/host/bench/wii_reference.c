@@ -0,0 +1,159 @@
+// The wii extension decoders as they were written by hand, before they were
+// generated from the layouts in wii_layouts.h. Kept as the reference that the
+// generated ones have to match.
+#include "wii_decoders.h"
+#include "config/defines.h"
+#include "eeprom/eeprom.h"
+#include "fxpt_math/fxpt_math.h"
+#include "util/util.h"
+
+void referenceReadDrumExt(Controller_t *controller, uint8_t *data) {
+  controller->l_x = (data[0] - 0x20) << 10;
+  controller->l_y = (data[1] - 0x20) << 10;
+  // Mask out unused bits
+  buttons = ~(data[4] | (data[5] << 8)) & 0xfeff;
+  if (fullDeviceType >= MIDI_GAMEPAD && bit_check(data[3], 1)) {
+    uint8_t vel = (7 - (data[3] >> 5)) << 5;
+    uint8_t which = (data[2] & 0b01111100) >> 1;
+    switch (which) {
+    case 0x1B:
+      drumVelocity[XBOX_LB - 8] = vel;
+      break;
+    case 0x19:
+      drumVelocity[XBOX_B - 8] = vel;
+      break;
+    case 0x11:
+      drumVelocity[XBOX_X - 8] = vel;
+      break;
+    case 0x0F:
+      drumVelocity[XBOX_Y - 8] = vel;
+      break;
+    case 0x0E:
+      drumVelocity[XBOX_RB - 8] = vel;
+      break;
+    case 0x12:
+      drumVelocity[XBOX_A - 8] = vel;
+      break;
+    default:
+      break;
+    }
+  }
+  // The standard extension bindings are almost correct, but x and y are
+  // swapped, so swap them
+  bit_write(!bit_check(data[5], 3), buttons, wiiButtonBindings[XBOX_X]);
+  bit_write(!bit_check(data[5], 5), buttons, wiiButtonBindings[XBOX_Y]);
+  bit_write(!bit_check(data[5], 7), buttons, wiiButtonBindings[XBOX_RB]);
+  bit_write(!bit_check(data[5], 2), buttons, wiiButtonBindings[XBOX_LB]);
+}
+static const uint8_t wiiwttapbindings[] = {
+    [0x2] = (_BV(XBOX_A)) >> 8,
+    [0x3] = (_BV(XBOX_A) | _BV(XBOX_B)) >> 8,
+    [0x5] = (_BV(XBOX_B)) >> 8,
+    [0x6] = (_BV(XBOX_B) | _BV(XBOX_X)) >> 8,
+    [0x9] = (_BV(XBOX_Y)) >> 8,
+    [0xa] = (_BV(XBOX_X) | _BV(XBOX_Y)) >> 8,
+    [0xb] = (_BV(XBOX_X)) >> 8,
+    [0xc] = (_BV(XBOX_X)) >> 8,
+    [0xd] = (_BV(XBOX_X) | _BV(XBOX_LB)) >> 8,
+    [0xf] = (_BV(XBOX_LB)) >> 8};
+
+void referenceReadGuitarExt(Controller_t *controller, uint8_t *data) {
+  controller->l_x = ((data[0] & 0x3f) - 32) << 10;
+  controller->l_y = ((data[1] & 0x3f) - 32) << 10;
+  // Whammy is weird, it ranges from 0 - 12. multiply by 2.5 to get from 0 - 36,
+  // clamp, and then shift to 0 - 65535
+  controller->r_x = ((data[3] & 0x1f) - 14);
+  if (controller->r_x < 0) { controller->r_x = 0; }
+  controller->r_x = (controller->r_x << 1) + controller->r_x;
+  if (controller->r_x > 31) { controller->r_x = 31; }
+  controller->r_x -= 16;
+  controller->r_x <<= 11;
+
+  buttons = ~(data[4] | data[5] << 8);
+  if (guitarTapBar) {
+    // Bounds checked the same as wii_ext.h, which this didn't used to be
+    uint8_t tap = ((data[2] & 0x1f) - 14) >> 1;
+    if (tap < sizeof(wiiwttapbindings)) {
+      buttons |= wiiwttapbindings[tap] << 8;
+    }
+  }
+}
+void referenceReadClassicExtHighRes(Controller_t *controller, uint8_t *data) {
+  controller->l_x = (data[0] - 0x80) << 8;
+  controller->l_y = (data[2] - 0x80) << 8;
+  controller->r_x = (data[1] - 0x80) << 8;
+  controller->r_y = (data[3] - 0x80) << 8;
+  controller->lt = data[4];
+  controller->rt = data[5];
+  buttons = ~(data[6] | (data[7] << 8));
+}
+void referenceReadClassicExt(Controller_t *controller, uint8_t *data) {
+  controller->l_x = (data[0] & 0x3f) - 32;
+  controller->l_y = (data[1] & 0x3f) - 32;
+  controller->r_x =
+      ((((data[0] & 0xc0) >> 3) | ((data[1] & 0xc0) >> 5) | (data[2] >> 7)) -
+       16)
+      << 10;
+  controller->r_y = ((data[2] & 0x1f) - 16) << 10;
+  controller->lt = ((data[3] >> 5) | ((data[2] & 0x60) >> 2));
+  controller->rt = data[3] & 0x1f;
+  buttons = ~(data[4] | data[5] << 8);
+}
+void referenceReadNunchukExt(Controller_t *controller, uint8_t *data) {
+  controller->l_x = (data[0] - 0x80) << 8;
+  controller->l_y = (data[1] - 0x80) << 8;
+  if (mapNunchukAccelToRightJoy) {
+    uint16_t accX = ((data[2] << 2) | ((data[5] & 0xC0) >> 6)) - 511;
+    uint16_t accY = ((data[3] << 2) | ((data[5] & 0x30) >> 4)) - 511;
+    uint16_t accZ = ((data[4] << 2) | ((data[5] & 0xC) >> 2)) - 511;
+    // Same angles as wii_ext.h, as only the layout is being compared
+    controller->r_x = fxpt_atan2_fast(accX, accZ);
+    controller->r_y = fxpt_atan2_fast(accY, accZ);
+  }
+  buttons = 0;
+  bit_write(!bit_check(data[5], 0), buttons, wiiButtonBindings[XBOX_A]);
+  bit_write(!bit_check(data[5], 1), buttons, wiiButtonBindings[XBOX_B]);
+}
+void referenceReadDJExt(Controller_t *controller, uint8_t *data) {
+  uint8_t rtt =
+      (data[2] & 0x80) >> 7 | (data[1] & 0xC0) >> 5 | (data[0] & 0xC0) >> 3;
+
+  uint8_t ltt =
+      (data[4] & 1) ? 32 + (0x1F - (data[3] & 0x1F)) : 32 - (data[3] & 0x1F);
+  rtt = (data[2] & 1) ? 32 + (0x1F - rtt) : 32 - rtt;
+  uint8_t effect_dial = (data[3] & 0xE0) >> 5 | (data[2] & 0x60) >> 2;
+  uint8_t crossfade = (data[2] & 0x1E) >> 1;
+
+  controller->l_x = ltt;
+  controller->l_y = rtt;
+  controller->r_x = effect_dial;
+  controller->r_y = crossfade;
+
+  buttons = ~(data[4] << 8 | data[5]) & 0x63CD;
+
+  int8_t l_x = ((data[0] & 0x3F) - 0x20);
+  int8_t l_y = ((data[1] & 0x3F) - 0x20);
+  if (l_x < -32) { bit_set(controller->buttons, XBOX_DPAD_LEFT); }
+  if (l_x > 32) { bit_set(controller->buttons, XBOX_DPAD_RIGHT); }
+  if (l_y < -32) { bit_set(controller->buttons, XBOX_DPAD_UP); }
+  if (l_y > 32) { bit_set(controller->buttons, XBOX_DPAD_DOWN); }
+}
+void referenceReadUDrawExt(Controller_t *controller, uint8_t *data) {
+  controller->l_x = ((data[2] & 0x0f) << 8) | data[0];
+  controller->l_y = ((data[2] & 0xf0) << 4) | data[1];
+  controller->rt = data[3];
+  buttons = 0;
+  bit_write(bit_check(data[5], 0), buttons, wiiButtonBindings[XBOX_A]);
+  bit_write(bit_check(data[5], 1), buttons, wiiButtonBindings[XBOX_B]);
+  bit_write(!bit_check(data[5], 2), buttons, wiiButtonBindings[XBOX_X]);
+}
+void referenceReadDrawsomeExt(Controller_t *controller, uint8_t *data) {
+  controller->l_x = data[0] | data[1] << 8;
+  controller->l_y = data[2] | data[3] << 8;
+  controller->rt = data[4] | (data[5] & 0x0f) << 8;
+  // controller->status = data[5]>>4;
+}
+void referenceReadTataconExt(Controller_t *controller, uint8_t *data) {
+  // We can just skip all the other bytes except for the buttons
+  buttons = ~(data[0]);
+}
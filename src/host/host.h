@@ -0,0 +1,62 @@
+#pragma once
+// Controls for the fake hardware used by the host build. The firmware never
+// includes this, it is only used by the host tools that drive the shared code.
+#include "config/config.h"
+#include "pins_arduino.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The host build runs on a virtual clock. Time only moves forward when a tool
+// advances it, when the firmware busy waits, or by a single microsecond every
+// time micros() is read (so that polling loops with timeouts still finish).
+void hostAdvanceMicros(uint32_t us);
+// Total amount of time the firmware has spent inside _delay_us / _delay_ms.
+uint64_t hostBusyWaitMicros(void);
+// Called whenever the virtual clock is read, delivers any pending "interrupts"
+void hostServiceInterrupts(void);
+
+// Digital levels seen by digitalRead / digitalReadPin, and 10 bit analog
+// values seen by analogRead / tickAnalog.
+extern bool hostPinLevels[NUM_DIGITAL_PINS];
+extern uint16_t hostAnalogLevels[NUM_ANALOG_INPUTS];
+// Sets a digital level, and delivers a pin change to the firmware if it is
+// capturing edges on that pin.
+void hostSetPin(uint8_t pin, bool level);
+
+// Fake wii extension, attached at the normal extension address.
+void hostWiiSetExtension(uint16_t id);
+// Sets the extension registers, starting from pointer
+void hostWiiSetData(uint8_t pointer, const uint8_t *data, uint8_t len);
+// Fake MotionPlus, between the controller and the fake extension. Rates are
+// the raw 14 bit values, centred on 0x2000.
+void hostWiiSetMotionPlus(bool present);
+void hostWiiSetGyro(uint16_t yaw, uint16_t roll, uint16_t pitch, bool slow);
+// Fake GH5 neck / DJ hero turntable platters
+void hostI2CSetRegisters(uint8_t address, uint8_t pointer, const uint8_t *data,
+                         uint8_t len);
+
+// Fake PSX controller, answering on the SPI bus while attention is low.
+void hostPS2SetGuitar(bool guitar);
+void hostPS2SetButtons(uint16_t buttons);
+void hostPS2SetSticks(uint8_t rx, uint8_t ry, uint8_t lx, uint8_t ly);
+// Answer polls with a captured reply, starting from the id byte. Overrides
+// anything set above until the next call to hostPS2SetGuitar.
+void hostPS2SetReply(const uint8_t *frame, uint8_t len);
+void hostPS2Attention(bool active);
+
+// The configuration returned by loadConfig
+void hostSetConfig(const Configuration_t *config);
+
+// Every output sub type, along with its name
+typedef struct {
+  uint8_t type;
+  const char *name;
+} HostSubType_t;
+extern const HostSubType_t hostSubTypes[];
+extern const size_t hostSubTypeCount;
+// Sets fullDeviceType, deviceType and typeIs* the same way the platform main
+// loops do. With BAKED_CONFIG the sub type is fixed, so only deviceType is set.
+void hostSetDeviceType(uint8_t subType);
+// Mirrors initialise() from the platform main loops
+void hostInitialise(Configuration_t *config);
@@ -0,0 +1,4 @@
+#include "bootloader/bootloader.h"
+// There is nothing to reboot into on the host.
+void reboot(void) {}
+void bootloader(void) {}
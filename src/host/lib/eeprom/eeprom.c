@@ -0,0 +1,30 @@
+#include "eeprom/eeprom.h"
+#include "host.h"
+#include <string.h>
+static Configuration_t stored = DEFAULT_CONFIG;
+#ifdef BAKED_CONFIG
+static const uint8_t baked_config[sizeof(Configuration_t)] = {
+    BAKED_CONFIG_BYTES};
+#endif
+void loadConfig(Configuration_t *config) {
+#ifdef BAKED_CONFIG
+  memcpy(config, baked_config, sizeof(Configuration_t));
+#else
+  memcpy(config, &stored, sizeof(Configuration_t));
+#endif
+}
+void writeConfigByte(uint16_t offset, uint8_t byte) {
+  ((uint8_t *)&stored)[offset] = byte;
+}
+void writeConfigBlock(uint16_t offset, const uint8_t *data, uint16_t len) {
+  memcpy(((uint8_t *)&stored) + offset, data, len);
+}
+void commitConfig(void) {}
+void readConfigBlock(uint16_t offset, uint8_t *data, uint16_t len) {
+  memcpy(data, ((uint8_t *)&stored) + offset, len);
+}
+void resetConfig(void) {
+  const Configuration_t def = DEFAULT_CONFIG;
+  stored = def;
+}
+void hostSetConfig(const Configuration_t *config) { stored = *config; }
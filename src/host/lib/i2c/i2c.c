@@ -0,0 +1,183 @@
+#include "i2c/i2c.h"
+#include "config/defines.h"
+#include "host.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+// Register file style fake devices. Every device has a pointer that is set by
+// the first byte of a write, and auto increments on reads and writes, which is
+// how the wii extensions and the GH5 / DJ Hero peripherals behave.
+#define WII_ADDR 0x52
+#define WII_ID_PTR 0xFA
+#define MOTION_PLUS_ADDR 0x53
+typedef struct {
+  uint8_t address;
+  bool present;
+  uint8_t pointer;
+  uint8_t regs[256];
+} FakeDevice_t;
+static FakeDevice_t devices[] = {{.address = WII_ADDR},
+                                 {.address = 0x0D},
+                                 {.address = 0x0E}};
+
+static FakeDevice_t *findDevice(uint8_t address) {
+  for (size_t i = 0; i < sizeof(devices) / sizeof(devices[0]); i++) {
+    if (devices[i].address == address && devices[i].present) {
+      return &devices[i];
+    }
+  }
+  return NULL;
+}
+// A fake MotionPlus, plugged in between the controller and the fake extension.
+// Until it is switched on it only answers its id at MOTION_PLUS_ADDR, and the
+// extension is seen as normal. Once it is switched on it takes over WII_ADDR,
+// and its reads alternate between gyro frames and the extension's data packed
+// the way the MotionPlus packs it, if there is an extension.
+static struct {
+  bool present;
+  uint8_t mode;
+  uint8_t pointer;
+  bool gyroNext;
+  uint16_t yaw, roll, pitch;
+  bool slow;
+} motionPlus;
+static void readMotionPlus(uint8_t *data, uint8_t length) {
+  uint8_t frame[6] = {0};
+  // Gyro frames say whether there is an extension whatever the mode is, but
+  // it is only passed through outside of standalone mode
+  bool ext = devices[0].present;
+  bool passthrough = ext && motionPlus.mode != 0x04;
+  if (motionPlus.pointer >= WII_ID_PTR) {
+    const uint8_t id[6] = {0x00, 0x00, 0xA4, 0x20, motionPlus.mode, 0x05};
+    memcpy(frame, id, sizeof(id));
+  } else if (passthrough && !motionPlus.gyroNext) {
+    const uint8_t *in = devices[0].regs;
+    memcpy(frame, in, sizeof(frame));
+    frame[4] = (in[4] & 0xFE) | 1;
+    if (motionPlus.mode == 0x05) {
+      frame[5] = (in[4] & 1) << 7 | (in[5] & 0x80) >> 1 | (in[5] & 0x20) |
+                 (in[5] & 0x08) << 1 | (in[5] & 0x03) << 2;
+    } else {
+      frame[0] = (in[0] & 0xFE) | (in[5] & 1);
+      frame[1] = (in[1] & 0xFE) | (in[5] >> 1 & 1);
+      frame[5] = in[5] & 0xFC;
+    }
+  } else {
+    frame[0] = motionPlus.yaw;
+    frame[1] = motionPlus.roll;
+    frame[2] = motionPlus.pitch;
+    frame[3] = (motionPlus.yaw >> 8) << 2 | motionPlus.slow << 1 |
+               motionPlus.slow;
+    frame[4] = (motionPlus.roll >> 8) << 2 | motionPlus.slow << 1 | ext;
+    frame[5] = (motionPlus.pitch >> 8) << 2 | 0x02;
+  }
+  if (passthrough) motionPlus.gyroNext = !motionPlus.gyroNext;
+  memcpy(data, frame, length < sizeof(frame) ? length : sizeof(frame));
+}
+static bool writeMotionPlus(uint8_t address, uint8_t *data, uint8_t length) {
+  motionPlus.pointer = data[0];
+  if (length < 2) return true;
+  if (address == MOTION_PLUS_ADDR && data[0] == 0xFE) {
+    motionPlus.mode = data[1];
+    motionPlus.gyroNext = true;
+  } else if (address == WII_ADDR && data[0] == 0xF0 && data[1] == 0x55) {
+    motionPlus.mode = 0;
+  }
+  return true;
+}
+void twi_init(bool fivetar, bool dj) {}
+void twi_disable(void) {}
+bool twi_readFrom(uint8_t address, uint8_t *data, uint8_t length,
+                  uint8_t sendStop) {
+  if (motionPlus.present) {
+    if (address == WII_ADDR && motionPlus.mode) {
+      readMotionPlus(data, length);
+      return true;
+    }
+    if (address == MOTION_PLUS_ADDR && !motionPlus.mode) {
+      memset(data, 0, length);
+      const uint8_t id[6] = {0x00, 0x00, 0xA6, 0x20, 0x00, 0x05};
+      if (motionPlus.pointer == WII_ID_PTR) {
+        memcpy(data, id, length < sizeof(id) ? length : sizeof(id));
+      }
+      return true;
+    }
+  }
+  FakeDevice_t *dev = findDevice(address);
+  if (!dev) return false;
+  for (uint8_t i = 0; i < length; i++) { data[i] = dev->regs[dev->pointer++]; }
+  return true;
+}
+bool twi_writeTo(uint8_t address, uint8_t *data, uint8_t length, uint8_t wait,
+                 uint8_t sendStop) {
+  if (motionPlus.present && length &&
+      ((address == WII_ADDR && motionPlus.mode) ||
+       (address == MOTION_PLUS_ADDR && !motionPlus.mode))) {
+    return writeMotionPlus(address, data, length);
+  }
+  FakeDevice_t *dev = findDevice(address);
+  if (!dev || !length) return false;
+  dev->pointer = data[0];
+  for (uint8_t i = 1; i < length; i++) { dev->regs[dev->pointer++] = data[i]; }
+  return true;
+}
+void hostWiiSetExtension(uint16_t id) {
+  FakeDevice_t *dev = &devices[0];
+  dev->present = id != WII_NO_EXTENSION;
+  memset(dev->regs, 0, sizeof(dev->regs));
+  // Byte 0 and 5 of the id are what identify the extension. Writing 0x03 to
+  // 0xFE (byte 4 of the id) is how high res mode is enabled, which happens
+  // naturally as this is just a register file.
+  dev->regs[WII_ID_PTR] = id >> 8;
+  dev->regs[WII_ID_PTR + 1] = 0x00;
+  dev->regs[WII_ID_PTR + 2] = 0xA4;
+  dev->regs[WII_ID_PTR + 3] = 0x20;
+  dev->regs[WII_ID_PTR + 4] = 0x01;
+  dev->regs[WII_ID_PTR + 5] = id & 0xFF;
+}
+void hostWiiSetData(uint8_t pointer, const uint8_t *data, uint8_t len) {
+  memcpy(devices[0].regs + pointer, data, len);
+}
+void hostWiiSetMotionPlus(bool present) {
+  memset(&motionPlus, 0, sizeof(motionPlus));
+  motionPlus.present = present;
+  motionPlus.yaw = motionPlus.roll = motionPlus.pitch = 0x2000;
+  motionPlus.slow = true;
+}
+void hostWiiSetGyro(uint16_t yaw, uint16_t roll, uint16_t pitch, bool slow) {
+  motionPlus.yaw = yaw;
+  motionPlus.roll = roll;
+  motionPlus.pitch = pitch;
+  motionPlus.slow = slow;
+}
+void hostI2CSetRegisters(uint8_t address, uint8_t pointer, const uint8_t *data,
+                         uint8_t len) {
+  for (size_t i = 0; i < sizeof(devices) / sizeof(devices[0]); i++) {
+    if (devices[i].address == address) {
+      devices[i].present = true;
+      memcpy(devices[i].regs + pointer, data, len);
+    }
+  }
+}
+// The fake devices answer straight away, so the async transfers are done as
+// soon as they are started
+static uint8_t asyncData[TWI_BUFFER_LENGTH];
+static uint8_t asyncLength;
+static bool asyncOk;
+bool twi_startWrite(uint8_t address, uint8_t *data, uint8_t length) {
+  asyncLength = 0;
+  asyncOk = twi_writeTo(address, data, length, false, true);
+  return true;
+}
+bool twi_startRead(uint8_t address, uint8_t length) {
+  if (length > TWI_BUFFER_LENGTH) return false;
+  asyncLength = length;
+  asyncOk = twi_readFrom(address, asyncData, length, true);
+  return true;
+}
+uint8_t twi_poll(uint8_t *data) {
+  if (!asyncOk) return TWI_ASYNC_FAILED;
+  memcpy(data, asyncData, asyncLength);
+  return TWI_ASYNC_DONE;
+}
+void twi_cancel(void) { asyncOk = false; }
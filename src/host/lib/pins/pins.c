@@ -0,0 +1,126 @@
+#include "pins/pins.h"
+#include "eeprom/eeprom.h"
+#include "host.h"
+#include "pins_arduino.h"
+#include "timer/timer.h"
+#include "util/util.h"
+#include <stddef.h>
+
+bool hostPinLevels[NUM_DIGITAL_PINS];
+uint16_t hostAnalogLevels[NUM_ANALOG_INPUTS];
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  hostPinLevels[pin] = val;
+  if (pin == PIN_PS2_ATT) hostPS2Attention(!val);
+}
+
+bool digitalRead(uint8_t pin) { return hostPinLevels[pin]; }
+void setUpDigital(Pin_t *pin, Configuration_t *config, uint8_t pinNum,
+                  uint8_t offset, bool inverted, bool output) {
+  pin->offset = offset;
+  pin->pin = pinNum;
+  pin->eq = inverted;
+  pin->sioFunc = true;
+  pin->analogOffset = INVALID_PIN;
+}
+unsigned long digitalReadPulse(Pin_t *pin, uint8_t state,
+                               unsigned long timeout) {
+  // Nothing on the host generates pulses, so this always times out.
+  hostAdvanceMicros(timeout);
+  return 0;
+}
+bool digitalReadPin(Pin_t *pin) {
+  if (pin->analogOffset == INVALID_PIN) {
+    return hostPinLevels[pin->pin] == pin->eq;
+  }
+  AnalogInfo_t info = joyData[pin->analogOffset];
+  return info.value > info.threshold;
+}
+void digitalWritePin(Pin_t *pin, bool value) { digitalWrite(pin->pin, value); }
+// Mirrors the pico, where every gpio lives in the one bank
+uint8_t pinPort(Pin_t *pin) { return 0; }
+uint8_t pinBit(Pin_t *pin) { return pin->pin; }
+port_t readPort(uint8_t port) {
+  port_t ret = 0;
+  for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
+    if (hostPinLevels[i]) { ret |= (port_t)1 << i; }
+  }
+  return ret;
+}
+uint8_t digitalPinPort(uint8_t pin) { return 0; }
+port_t digitalPinMask(uint8_t pin) { return (port_t)1 << pin; }
+void pullUpPort(uint8_t port, port_t mask) {
+  for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
+    if (mask & ((port_t)1 << i)) { hostPinLevels[i] = true; }
+  }
+}
+#ifdef CAPTURE_EDGES
+static port_t pinChangeMask;
+bool enablePinChange(Pin_t *pin) {
+  pinChangeMask |= (port_t)1 << pin->pin;
+  return true;
+}
+#endif
+void hostSetPin(uint8_t pin, bool level) {
+  if (hostPinLevels[pin] == level) return;
+  hostPinLevels[pin] = level;
+#ifdef CAPTURE_EDGES
+  if (pinChangeMask & ((port_t)1 << pin)) { pinChanged(0, readPort(0)); }
+#endif
+}
+void setUpAnalogPin(Configuration_t *config, uint8_t offset) {
+  AnalogInfo_t ret = {0};
+  ret.offset = offset;
+  AnalogPin_t apin = ((PinsCombined_t *)&config->pins)->axis[offset];
+  uint8_t pin = apin.pin;
+  if (pin == INVALID_PIN) { return; }
+  if (ret.offset == 5 && typeIsGuitar && config->main.tiltType != ANALOGUE) {
+    return;
+  }
+  ret.pin = pin;
+  ret.hasDigital = false;
+  ret.inverted = apin.inverted;
+  pinMode(pin, INPUT);
+  joyData[validAnalog++] = ret;
+}
+void setUpAnalogDigitalPin(Pin_t *button, uint8_t pin, uint16_t threshold) {
+  AnalogInfo_t ret = {0};
+  ret.offset = pin;
+  ret.hasDigital = true;
+  ret.threshold = threshold;
+  ret.pin = pin;
+  pinMode(pin, INPUT);
+  button->analogOffset = validAnalog;
+  joyData[validAnalog++] = ret;
+}
+void tickAnalog(void) {
+  if (validAnalog == 0) return;
+  for (int i = 0; i < validAnalog; i++) {
+    AnalogInfo_t *info = &joyData[i];
+    int16_t data = analogRead(info->pin - PIN_A0);
+    // Drums are compared against their threshold as they are
+    if (!joyData[i].hasDigital) {
+      data = (data - 512);
+      if (info->inverted) data = -data;
+      data = data * 64;
+    }
+    info->value = data;
+  }
+}
+
+uint16_t analogRead(uint8_t pin) {
+  if (pin >= NUM_ANALOG_INPUTS) return 0;
+  return hostAnalogLevels[pin];
+}
+void pinMode(uint8_t pin, uint8_t mode) {
+  // Pull ups idle high, until something drives the pin
+  if (mode == INPUT_PULLUP || mode == INPUT_PULLUP_ANALOG) {
+    hostPinLevels[pin] = true;
+  }
+}
+
+void setupADC(void) {}
+
+void setUpValidPins(Configuration_t *config) {
+  for (int i = 0; i < 6; i++) { setUpAnalogPin(config, i); }
+}
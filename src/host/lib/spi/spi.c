@@ -0,0 +1,90 @@
+#include "spi/spi.h"
+#include "host.h"
+#include "pins/pins.h"
+#include "util/util.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+// A fake PSX controller. It answers as a DualShock (0x73) in analog mode, or
+// as a guitar (a DualShock with dpad left held down). While in config mode it
+// answers with 0xF3, and stays there until it sees an exit config command.
+// Replies captured from a real controller can also be played back through it.
+#define PSX_ID_DUALSHOCK 0x73
+#define PSX_ID_CONFIG 0xF3
+volatile bool spi_acknowledged = false;
+static bool selected = false;
+static bool configMode = false;
+static bool ackPending = false;
+static bool guitar = false;
+static uint8_t byteIndex = 0;
+static uint8_t frameCmd = 0;
+static uint8_t frameArg = 0;
+static uint8_t id = PSX_ID_DUALSHOCK;
+// Big enough for the longest reply a controller can give (id 0x?9)
+static uint8_t reply[18] = {0xFF, 0xFF, 0x80, 0x80, 0x80, 0x80};
+
+void spi_begin(uint32_t clock, bool cpol, bool cpha, bool lsbfirst) {}
+void spi_high(void) {}
+void init_ack(Pin_t ack) {}
+uint8_t spi_transfer(uint8_t data) {
+  if (!selected) return 0xFF;
+  uint8_t resp = 0xFF;
+  switch (byteIndex) {
+  case 0:
+    break;
+  case 1:
+    frameCmd = data;
+    resp = configMode ? PSX_ID_CONFIG : id;
+    break;
+  case 2:
+    resp = 0x5A;
+    break;
+  default:
+    if (byteIndex == 3) frameArg = data;
+    if (byteIndex - 3 < (int)sizeof(reply)) resp = reply[byteIndex - 3];
+    break;
+  }
+  byteIndex++;
+  ackPending = true;
+  return resp;
+}
+void hostServiceInterrupts(void) {
+  // The controller pulses ack shortly after every byte
+  if (ackPending) {
+    ackPending = false;
+    spi_acknowledged = true;
+  }
+}
+void hostPS2Attention(bool active) {
+  if (active && !selected) { byteIndex = 0; }
+  if (!active && selected && frameCmd == 0x43 && byteIndex > 3) {
+    configMode = frameArg == 0x01;
+  }
+  selected = active;
+}
+void hostPS2SetGuitar(bool isGuitar) {
+  guitar = isGuitar;
+  id = PSX_ID_DUALSHOCK;
+  hostPS2SetButtons(0);
+}
+void hostPS2SetButtons(uint16_t buttons) {
+  // Guitars look like a DualShock that always has dpad left held
+  if (guitar) buttons |= _BV(7);
+  buttons = ~buttons;
+  reply[0] = buttons & 0xFF;
+  reply[1] = buttons >> 8;
+}
+void hostPS2SetSticks(uint8_t rx, uint8_t ry, uint8_t lx, uint8_t ly) {
+  reply[2] = rx;
+  reply[3] = ry;
+  reply[4] = lx;
+  reply[5] = ly;
+}
+void hostPS2SetReply(const uint8_t *frame, uint8_t len) {
+  // Skip over the id and the 0x5A that follows it
+  if (len < 2) return;
+  id = frame[0];
+  len -= 2;
+  if (len > sizeof(reply)) len = sizeof(reply);
+  memcpy(reply, frame + 2, len);
+}
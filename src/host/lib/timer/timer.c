@@ -0,0 +1,27 @@
+#include "host.h"
+#include "timer/timer.h"
+#include <stdint.h>
+
+static uint64_t now = 0;
+static uint64_t busyWait = 0;
+
+unsigned long millis(void) { return micros() / 1000; }
+
+unsigned long micros(void) {
+  now++;
+  hostServiceInterrupts();
+  return now;
+}
+
+void setupMicrosTimer(void) {}
+
+void _delay_us(uint32_t __us) {
+  now += __us;
+  busyWait += __us;
+}
+
+void _delay_ms(uint32_t __ms) { _delay_us(__ms * 1000); }
+
+void hostAdvanceMicros(uint32_t us) { now += us; }
+
+uint64_t hostBusyWaitMicros(void) { return busyWait; }
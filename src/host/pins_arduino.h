@@ -0,0 +1,22 @@
+#pragma once
+// Pin layout for the host build. There is no real hardware behind these, but
+// the layout roughly follows the pro micro so that the shared code sees the
+// same kind of pin numbers it would on a real board.
+#define NUM_DIGITAL_PINS 30
+#define PIN_A0 22
+#define PIN_A1 23
+#define PIN_A2 24
+#define PIN_A3 25
+#define NUM_ANALOG_INPUTS 8
+#define PIN_WIRE_SDA 2
+#define PIN_WIRE_SCL 3
+#define PIN_SPI_MOSI 16
+#define PIN_SPI_MISO 14
+#define PIN_SPI_SCK 15
+#define PIN_SPI_SS 17
+#define PIN_PS2_ACK 7
+#define PIN_PS2_ATT 10
+#define PIN_RF_IRQ 7
+#define PIN_WT_NECK 9
+#define CE 0
+#define CSN PIN_SPI_SS
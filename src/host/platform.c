@@ -0,0 +1,76 @@
+// Things that the platform specific main.c usually provides, shared by all of
+// the host tools.
+#include "config/defines.h"
+#include "controller/guitar_includes.h"
+#include "eeprom/eeprom.h"
+#include "host.h"
+#include "input/input_handler.h"
+#include "leds/leds.h"
+#include "output/reports.h"
+#include "output/serial_handler.h"
+#include "timer/timer.h"
+int validAnalog = 0;
+bool isRF = false;
+#ifndef BAKED_CONFIG
+bool typeIsGuitar;
+bool typeIsDrum;
+bool typeIsDJ;
+uint8_t fullDeviceType;
+#endif
+uint8_t inputType;
+uint8_t deviceType;
+Controller_t controller;
+void stopReading(void) {}
+void writeToUSB(const void *const Buffer, uint8_t Length, uint8_t report,
+                const void *request) {}
+
+#define SUB_TYPE(name)                                                         \
+  { name, #name }
+const HostSubType_t hostSubTypes[] = {
+    SUB_TYPE(XINPUT_GAMEPAD),           SUB_TYPE(XINPUT_WHEEL),
+    SUB_TYPE(XINPUT_ARCADE_STICK),      SUB_TYPE(XINPUT_FLIGHT_STICK),
+    SUB_TYPE(XINPUT_DANCE_PAD),         SUB_TYPE(XINPUT_LIVE_GUITAR),
+    SUB_TYPE(XINPUT_ROCK_BAND_DRUMS),   SUB_TYPE(XINPUT_GUITAR_HERO_DRUMS),
+    SUB_TYPE(XINPUT_ROCK_BAND_GUITAR),  SUB_TYPE(XINPUT_GUITAR_HERO_GUITAR),
+    SUB_TYPE(XINPUT_ARCADE_PAD),        SUB_TYPE(XINPUT_TURNTABLE),
+    SUB_TYPE(KEYBOARD_GAMEPAD),         SUB_TYPE(KEYBOARD_GUITAR_HERO_GUITAR),
+    SUB_TYPE(KEYBOARD_ROCK_BAND_GUITAR),SUB_TYPE(KEYBOARD_LIVE_GUITAR),
+    SUB_TYPE(KEYBOARD_GUITAR_HERO_DRUMS),SUB_TYPE(KEYBOARD_ROCK_BAND_DRUMS),
+    SUB_TYPE(SWITCH_GAMEPAD),           SUB_TYPE(PS3_GUITAR_HERO_GUITAR),
+    SUB_TYPE(PS3_GUITAR_HERO_DRUMS),    SUB_TYPE(PS3_ROCK_BAND_GUITAR),
+    SUB_TYPE(PS3_ROCK_BAND_DRUMS),      SUB_TYPE(PS3_GAMEPAD),
+    SUB_TYPE(PS3_TURNTABLE),            SUB_TYPE(PS3_LIVE_GUITAR),
+    SUB_TYPE(WII_ROCK_BAND_GUITAR),     SUB_TYPE(WII_ROCK_BAND_DRUMS),
+    SUB_TYPE(MOUSE),                    SUB_TYPE(MIDI_GAMEPAD),
+    SUB_TYPE(MIDI_GUITAR_HERO_GUITAR),  SUB_TYPE(MIDI_ROCK_BAND_GUITAR),
+    SUB_TYPE(MIDI_LIVE_GUITAR),         SUB_TYPE(MIDI_GUITAR_HERO_DRUMS),
+    SUB_TYPE(MIDI_ROCK_BAND_DRUMS)};
+const size_t hostSubTypeCount = sizeof(hostSubTypes) / sizeof(hostSubTypes[0]);
+
+void hostSetDeviceType(uint8_t subType) {
+#ifndef BAKED_CONFIG
+  fullDeviceType = subType;
+  typeIsDrum = isDrum(fullDeviceType);
+  typeIsGuitar = isGuitar(fullDeviceType);
+  typeIsDJ = isDJ(fullDeviceType);
+#endif
+  deviceType = fullDeviceType;
+  if (typeIsGuitar && deviceType <= XINPUT_TURNTABLE) {
+    deviceType = REAL_GUITAR_SUBTYPE;
+  }
+  if (typeIsDrum && deviceType <= XINPUT_TURNTABLE) {
+    deviceType = REAL_DRUM_SUBTYPE;
+  }
+}
+
+// Mirrors initialise() from the platform main loops
+void hostInitialise(Configuration_t *config) {
+  hostSetConfig(config);
+  loadConfig(config);
+  hostSetDeviceType(config->main.subType);
+  inputType = config->main.inputType;
+  setupMicrosTimer();
+  initInputs(config);
+  initReports(config);
+  initLEDs(config);
+}
@@ -0,0 +1,259 @@
+// Replays a recording captured with scripts/record.py (from a firmware built
+// with RECORD_INPUTS) through the shared code. Raw wii and PS2 captures are
+// fed back through the decoders, and the controller that comes out is checked
+// against the one the firmware recorded. Every recorded controller is then
+// run through every output sub type, to time report generation against a real
+// play session and to print a hash of the reports that were generated.
+// Recordings from direct mode only contain controllers, as the pins are
+// sampled too often to be worth capturing.
+//
+// ardwiino_replay_baked runs the same thing baked against BAKE_FROM, which
+// ignores the config in the recording, and only fills reports for the baked
+// sub type.
+#define _GNU_SOURCE
+#include "config/defines.h"
+#include "eeprom/eeprom.h"
+#include "host.h"
+#include "input/input_handler.h"
+#include "output/reports.h"
+#include "output/serial_handler.h"
+#include "stats/record.h"
+#include "timer/timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Must match scripts/record.py
+#define RECORDING_MAGIC "ARDWREC1"
+#define DEFAULT_ITERATIONS 100
+// Only print the first few mismatches, the rest are just counted
+#define MAX_PRINTED_MISMATCHES 10
+
+typedef struct {
+  RecordHeader_t header;
+  const uint8_t *data;
+} Record_t;
+
+static uint8_t *file;
+static Configuration_t config;
+static Record_t *records;
+static size_t recordCount;
+static Controller_t *snapshots;
+static size_t snapshotCount;
+
+static uint64_t nowNanos(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool load(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  file = malloc(len);
+  if (fread(file, 1, len, f) != (size_t)len) {
+    fclose(f);
+    fprintf(stderr, "unable to read %s\n", path);
+    return false;
+  }
+  fclose(f);
+  size_t pos = strlen(RECORDING_MAGIC);
+  if (len < (long)pos + 2 || memcmp(file, RECORDING_MAGIC, pos)) {
+    fprintf(stderr, "%s is not a recording\n", path);
+    return false;
+  }
+  uint16_t configLen = file[pos] | file[pos + 1] << 8;
+  pos += 2;
+  if (configLen != sizeof(Configuration_t) || pos + configLen > (size_t)len) {
+    fprintf(stderr,
+            "%s was recorded with a different config version (%u bytes, "
+            "expected %zu)\n",
+            path, configLen, sizeof(Configuration_t));
+    return false;
+  }
+  memcpy(&config, file + pos, configLen);
+  pos += configLen;
+  // Every record is at least a header, so this is plenty
+  records = malloc(sizeof(Record_t) * (len / sizeof(RecordHeader_t) + 1));
+  snapshots = malloc(sizeof(Controller_t) * (len / sizeof(Controller_t) + 1));
+  while (pos + sizeof(RecordHeader_t) <= (size_t)len) {
+    Record_t *record = &records[recordCount];
+    memcpy(&record->header, file + pos, sizeof(RecordHeader_t));
+    pos += sizeof(RecordHeader_t);
+    if (pos + record->header.len > (size_t)len) {
+      fprintf(stderr, "%s is truncated\n", path);
+      return false;
+    }
+    record->data = file + pos;
+    pos += record->header.len;
+    if (record->header.type == RECORD_CONTROLLER &&
+        record->header.len == sizeof(Controller_t)) {
+      memcpy(&snapshots[snapshotCount++], record->data, sizeof(Controller_t));
+    }
+    recordCount++;
+  }
+  return true;
+}
+
+static const Record_t *findFirst(uint8_t type) {
+  for (size_t i = 0; i < recordCount; i++) {
+    if (records[i].header.type == type) return &records[i];
+  }
+  return NULL;
+}
+
+static void apply(const Record_t *record) {
+  switch (record->header.type) {
+  case RECORD_WII_ID: {
+    // This also clears the data registers, so the next read fails and the
+    // firmware goes looking for the extension again, same as it did when this
+    // was recorded.
+    uint16_t id;
+    memcpy(&id, record->data, sizeof(id));
+    hostWiiSetExtension(id);
+    break;
+  }
+  case RECORD_WII:
+    hostWiiSetData(record->data[0], record->data + 1, record->header.len - 1);
+    break;
+  case RECORD_PS2:
+    hostPS2SetReply(record->data, record->header.len);
+    break;
+  }
+}
+
+// Feeds the raw captures back through the decoders, and returns how many of
+// the controllers that came out differ from the recorded ones.
+static size_t decode(void) {
+  // Set up the fake peripherals to look like whatever was attached, as that is
+  // worked out during the first tick.
+  const Record_t *firstId = findFirst(RECORD_WII_ID);
+  if (firstId) apply(firstId);
+  const Record_t *firstPS2 = findFirst(RECORD_PS2);
+  if (firstPS2) apply(firstPS2);
+  hostInitialise(&config);
+  size_t mismatches = 0, compared = 0;
+  // Recordings from direct mode have nothing to feed the decoders with
+  if (!firstId && !firstPS2) {
+    printf("no raw inputs recorded, skipping decode\n");
+    return 0;
+  }
+  uint32_t target = micros();
+  size_t i = 0;
+  while (i < recordCount) {
+    // The virtual clock also moves whenever it is read or the firmware waits,
+    // so work towards the recorded timestamps instead of adding the deltas
+    // blindly, and if the clock is ahead carry on from there. A saturated
+    // delta only says that at least that long passed, so wait the full amount
+    // from wherever the clock is.
+    uint16_t delta = records[i].header.delta;
+    if (delta == UINT16_MAX) { target = micros(); }
+    target += delta;
+    int32_t behind = target - micros();
+    if (behind > 0) {
+      hostAdvanceMicros(behind);
+    } else {
+      target -= behind;
+    }
+    // Records from the same tick have no time between them, apply all of them
+    // and then tick once.
+    const Record_t *expected = NULL;
+    do {
+      if (records[i].header.type == RECORD_CONTROLLER) {
+        expected = &records[i];
+      } else {
+        apply(&records[i]);
+      }
+      i++;
+    } while (i < recordCount && !records[i].header.delta);
+    tickInputs(&controller);
+    if (!expected) continue;
+    compared++;
+    if (memcmp(&controller, expected->data, sizeof(Controller_t))) {
+      if (mismatches < MAX_PRINTED_MISMATCHES) {
+        const Controller_t *c = (const Controller_t *)expected->data;
+        printf("record %zu: buttons %04x/%04x lt %u/%u rt %u/%u l %d,%d/%d,%d "
+               "r %d,%d/%d,%d (decoded/recorded)\n",
+               (size_t)(expected - records), controller.buttons, c->buttons,
+               controller.lt, c->lt, controller.rt, c->rt, controller.l_x,
+               controller.l_y, c->l_x, c->l_y, controller.r_x, controller.r_y,
+               c->r_x, c->r_y);
+      }
+      mismatches++;
+    }
+  }
+  printf("decoded %zu records, %zu controllers compared, %zu mismatched\n",
+         recordCount, compared, mismatches);
+  return mismatches;
+}
+
+static void fill(uint8_t subType, const char *name, int iterations) {
+  hostSetDeviceType(subType);
+  initReports(&config);
+  USB_Report_Data_t report;
+  uint8_t size;
+  // FNV-1a over every report, so that changes in the output are easy to spot
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < snapshotCount; i++) {
+    memset(&report, 0, sizeof(report));
+    fillReport(&report, &size, &snapshots[i]);
+    for (uint8_t j = 0; j < size; j++) {
+      hash = (hash ^ ((uint8_t *)&report)[j]) * 16777619u;
+    }
+  }
+  uint64_t start = nowNanos();
+  for (int n = 0; n < iterations; n++) {
+    for (size_t i = 0; i < snapshotCount; i++) {
+      fillReport(&report, &size, &snapshots[i]);
+    }
+  }
+  uint64_t end = nowNanos();
+  printf("%-28s %9.1f %08x\n", name,
+         (double)(end - start) / ((double)iterations * snapshotCount), hash);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s recording [iterations]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  int iterations = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+  if (!load(argv[1])) return EXIT_FAILURE;
+  if (!snapshotCount) {
+    fprintf(stderr, "%s has no controller records\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  size_t mismatches = decode();
+  printf("%-28s %9s %8s\n", "subtype", "fill ns", "hash");
+  int failures = 0;
+  for (size_t i = 0; i < hostSubTypeCount; i++) {
+#ifdef BAKED_CONFIG
+    // Only the baked sub type exists in a baked build
+    if (hostSubTypes[i].type != BAKED_SUB_TYPE) continue;
+#endif
+    // Each sub type gets a fresh copy of the report state
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+      fill(hostSubTypes[i].type, hostSubTypes[i].name, iterations);
+      fflush(stdout);
+      _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+      printf("%-28s failed\n", hostSubTypes[i].name);
+      failures++;
+    }
+  }
+  return mismatches || failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,10 @@
+#pragma once
+// Stand-in for the pico-sdk gpio header used by rf/rf.c
+#include <stdbool.h>
+#include <stdint.h>
+#define GPIO_IRQ_EDGE_FALL 0x4u
+#define GPIO_IRQ_EDGE_RISE 0x8u
+typedef void (*gpio_irq_callback_t)(unsigned int gpio, uint32_t events);
+void gpio_set_irq_enabled_with_callback(unsigned int gpio, uint32_t events,
+                                        bool enabled,
+                                        gpio_irq_callback_t callback);
@@ -0,0 +1,2 @@
+#pragma once
+// Stand-in for the pico-sdk header that util/util.h pulls in on non AVR builds
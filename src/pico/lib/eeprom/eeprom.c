@@ -9,13 +9,34 @@ const uint8_t *flash_target_contents =
     (const uint8_t *)(XIP_BASE + FLASH_TARGET_OFFSET);
 // Round to nearst 256 (FLASH_PAGE_SIZE)
 uint8_t newConfig[((sizeof(Configuration_t) >> 8) + 1) << 8];
+#ifdef BAKED_CONFIG
+static const uint8_t baked_config[sizeof(Configuration_t)] = {
+    BAKED_CONFIG_BYTES};
+#endif
 void loadConfig(Configuration_t* config) {
+#ifdef BAKED_CONFIG
+  memcpy(config, baked_config, sizeof(Configuration_t));
+  return;
+#endif
   memcpy(config, flash_target_contents, sizeof(Configuration_t));
+  // Anything that only writes part of the config still flashes all of it
+  memcpy(newConfig, flash_target_contents, sizeof(Configuration_t));
   if (config->main.signature != ARDWIINO_DEVICE_TYPE) {
     memcpy(config, &default_config, sizeof(Configuration_t));
     writeConfigBlock(0, (uint8_t *)config, sizeof(Configuration_t));
     return;
   }
+  // Version 19 made DebounceConfig_t bigger, so everything after it needs to
+  // move along before anything else touches it.
+  if (config->main.version < 19) {
+    memmove(&config->neck,
+            ((uint8_t *)&config->neck) - sizeof(config->debounce.eagerButtons) -
+                sizeof(config->debounce.eagerStrum),
+            sizeof(config->neck) + sizeof(config->deque));
+    // Older versions only had the leading edge debounce, so keep it
+    config->debounce.eagerButtons = true;
+    config->debounce.eagerStrum = true;
+  }
   // We made a change to simplify the guitar config, but as a result whammy is
   // now flipped
   if (config->main.version < 9 && isGuitar(config->main.subType)) {
@@ -70,20 +91,31 @@ void loadConfig(Configuration_t* config) {
     config->debounce.buttons *= 10;
     config->debounce.strum *= 10;
   }
+  if (config->main.version < 20) {
+    memcpy(&config->axisFilter, &default_config.axisFilter,
+           sizeof(default_config.axisFilter));
+  }
+  if (config->main.version < 21) {
+    memcpy(&config->axisCurve, &default_config.axisCurve,
+           sizeof(default_config.axisCurve));
+  }
+  if (config->main.version < 22) { config->autoCalibrate = 0; }
   if (config->main.version < CONFIG_VERSION) {
     config->main.version = CONFIG_VERSION;
     writeConfigBlock(0, (uint8_t *)config, sizeof(Configuration_t));
   }
 }
+void commitConfig(void) {
+  uint32_t saved_irq = save_and_disable_interrupts();
+  flash_range_erase(FLASH_TARGET_OFFSET, FLASH_SECTOR_SIZE);
+  flash_range_program(FLASH_TARGET_OFFSET, newConfig, sizeof(newConfig));
+  restore_interrupts(saved_irq);
+}
 void writeConfigBlock(uint16_t offset, const uint8_t *data, uint16_t len) {
   memcpy(newConfig + offset, data, len);
-  uint32_t saved_irq;
-  if (offset + len >= sizeof(Configuration_t)) {
-    saved_irq = save_and_disable_interrupts();
-    flash_range_erase(FLASH_TARGET_OFFSET, FLASH_SECTOR_SIZE);
-    flash_range_program(FLASH_TARGET_OFFSET, newConfig, sizeof(newConfig));
-    restore_interrupts(saved_irq);
-  }
+  // The configurator writes the config in order, so it is done once a write
+  // reaches the end
+  if (offset + len >= sizeof(Configuration_t)) { commitConfig(); }
 }
 void readConfigBlock(uint16_t offset, uint8_t *data, uint16_t len) {
   memcpy(data, flash_target_contents + offset, len);
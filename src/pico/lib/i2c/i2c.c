@@ -81,3 +81,59 @@ bool twi_writeTo(uint8_t address, uint8_t *data, uint8_t length, uint8_t wait,
                                         1000);
   return ret > 0;
 }
+// === MODIFIED ===
+// The sdk only has blocking transfers, so these queue the whole transfer into
+// the tx fifo themselves and let the hardware run it. A stop is sent after the
+// last byte, so the transfer is finished once the stop has been detected.
+static uint8_t asyncLength;
+static void startTransfer(uint8_t address, uint8_t length) {
+  i2c_hw_t *hw = i2c_get_hw(i2c1);
+  hw->enable = 0;
+  hw->tar = address;
+  hw->enable = 1;
+  (void)hw->clr_stop_det;
+  (void)hw->clr_tx_abrt;
+  asyncLength = length;
+}
+bool twi_startWrite(uint8_t address, uint8_t *data, uint8_t length) {
+  if (!length || length > 16) return false;
+  startTransfer(address, 0);
+  i2c_hw_t *hw = i2c_get_hw(i2c1);
+  for (uint8_t i = 0; i < length; i++) {
+    hw->data_cmd =
+        data[i] | (i == length - 1 ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+  }
+  return true;
+}
+bool twi_startRead(uint8_t address, uint8_t length) {
+  if (!length || length > 16) return false;
+  startTransfer(address, length);
+  i2c_hw_t *hw = i2c_get_hw(i2c1);
+  for (uint8_t i = 0; i < length; i++) {
+    hw->data_cmd = I2C_IC_DATA_CMD_CMD_BITS |
+                   (i == length - 1 ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+  }
+  return true;
+}
+uint8_t twi_poll(uint8_t *data) {
+  i2c_hw_t *hw = i2c_get_hw(i2c1);
+  uint32_t status = hw->raw_intr_stat;
+  if (!(status & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)) return TWI_ASYNC_BUSY;
+  (void)hw->clr_stop_det;
+  (void)hw->clr_tx_abrt;
+  if ((status & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) ||
+      hw->rxflr < asyncLength) {
+    twi_cancel();
+    return TWI_ASYNC_FAILED;
+  }
+  for (uint8_t i = 0; i < asyncLength; i++) { data[i] = hw->data_cmd; }
+  return TWI_ASYNC_DONE;
+}
+void twi_cancel(void) {
+  // Disabling the block throws away anything left in the fifos, so that the
+  // blocking calls don't read it back later
+  i2c_hw_t *hw = i2c_get_hw(i2c1);
+  hw->enable = 0;
+  hw->enable = 1;
+  asyncLength = 0;
+}
@@ -5,6 +5,13 @@
 #include "stddef.h"
 #include "util/util.h"
 #include "timer/timer.h"
+#ifdef CAPTURE_EDGES
+#  include "hardware/irq.h"
+#endif
+#ifdef ADC_SCAN
+#  include "hardware/dma.h"
+#  include <string.h>
+#endif
 
 void digitalWrite(uint8_t pin, uint8_t val) { gpio_put(pin, val); }
 
@@ -16,8 +23,6 @@ void setUpDigital(Pin_t* pin, Configuration_t *config, uint8_t pinNum, uint8_t o
   pin->eq = inverted;
   pin->sioFunc = true;
   pin->analogOffset = INVALID_PIN;
-  pin->milliDeBounce = config->debounce.buttons;
-  pin->lastMillis = 0;
 }
 unsigned long digitalReadPulse(Pin_t* pin, uint8_t state, unsigned long timeout)
 {
@@ -60,6 +65,48 @@ unsigned long digitalReadPulse(Pin_t* pin, uint8_t state, unsigned long timeout)
     return 0;
   }
 }
+// Every gpio on the pico lives in the one bank
+uint8_t pinPort(Pin_t *pin) { return 0; }
+uint8_t pinBit(Pin_t *pin) { return pin->pin; }
+port_t readPort(uint8_t port) { return gpio_get_all(); }
+uint8_t digitalPinPort(uint8_t pin) { return 0; }
+port_t digitalPinMask(uint8_t pin) { return 1u << pin; }
+void pullUpPort(uint8_t port, port_t mask) {
+  gpio_init_mask(mask);
+  for (uint8_t pin = 0; pin < NUM_DIGITAL_PINS; pin++) {
+    if (mask & (1u << pin)) { gpio_set_pulls(pin, true, false); }
+  }
+}
+#ifdef CAPTURE_EDGES
+// The sdk only has one gpio callback per core, and the RF and PS2 ack
+// interrupts set it for themselves, so captured pins are handled by a shared
+// handler instead. It runs before the callback does, and acknowledges the
+// edges on its own pins, so the callback only ever sees the other pins.
+#  define PIN_CHANGE_EVENTS (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL)
+static uint32_t pinChangeMask;
+static void pinChangeHandler(void) {
+  bool changed = false;
+  for (uint8_t pin = 0; pin < NUM_DIGITAL_PINS; pin++) {
+    if (!(pinChangeMask & (1u << pin))) continue;
+    uint32_t events = gpio_get_irq_event_mask(pin) & PIN_CHANGE_EVENTS;
+    if (events) {
+      gpio_acknowledge_irq(pin, events);
+      changed = true;
+    }
+  }
+  if (changed) { pinChanged(0, gpio_get_all()); }
+}
+bool enablePinChange(Pin_t *pin) {
+  if (!pinChangeMask) {
+    irq_add_shared_handler(IO_IRQ_BANK0, pinChangeHandler,
+                           PICO_SHARED_IRQ_HANDLER_HIGHEST_ORDER_PRIORITY);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+  }
+  pinChangeMask |= 1u << pin->pin;
+  gpio_set_irq_enabled(pin->pin, PIN_CHANGE_EVENTS, true);
+  return true;
+}
+#endif
 bool digitalReadPin(Pin_t* pin) {
   if (pin->analogOffset == INVALID_PIN) {
     return (gpio_get(pin->pin) != 0) == pin->eq;
@@ -108,21 +155,170 @@ void setUpAnalogDigitalPin(Pin_t *button, uint8_t pin, uint16_t threshold) {
   button->analogOffset = validAnalog;
   joyData[validAnalog++] = ret;
 }
+#ifdef ADC_SCAN
+// The ADC free runs, round robin over every channel in joyData, and one DMA
+// channel copies each sample out of the FIFO into adcScan as it arrives. When
+// it has filled adcScan a second channel points it back at the start, so the
+// whole thing runs forever without the cpu ever getting involved.
+//
+// adcScan holds as many whole passes over every channel as fit in
+// ADC_SCAN_SAMPLES, so that tickAnalog can take the latest value for each axis
+// from the last complete pass, and still hand every sample of a drum pad to
+// drumSampled. At one sample every ADC_SCAN_SAMPLE_US that is about 4ms of
+// samples, which covers even a slow tick.
+#  define ADC_SCAN_SAMPLES 2048
+#  define ADC_SCAN_SAMPLE_US 2
+volatile uint16_t adcScan[ADC_SCAN_SAMPLES];
+// Where each entry in joyData ends up in each pass
+uint8_t adcScanSlot[NUM_ANALOG_INPUTS];
+// The other way, for drums only, or INVALID_PIN
+uint8_t adcScanDrum[NUM_ANALOG_INPUTS];
+uint8_t adcScanCount;
+// The number of samples in the whole passes that fit in adcScan
+uint16_t adcScanTotal;
+// The next sample that hasn't been given to the drums
+uint16_t adcScanDrumRead;
+// Read by the control channel, as it can only copy from memory
+volatile uint16_t *adcScanStart = adcScan;
+int adcDataChannel = -1;
+int adcControlChannel = -1;
+bool adcScanning = false;
+void startADCScan(void) {
+  uint8_t mask = 0;
+  for (int i = 0; i < validAnalog; i++) {
+    mask |= 1 << (joyData[i].pin - PIN_A0);
+  }
+  // The round robin goes through the channels in order, so each one lands in
+  // the slot matching the number of channels below it.
+  uint8_t count = 0;
+  uint8_t first = 0;
+  for (uint8_t ch = NUM_ANALOG_INPUTS; ch--;) {
+    if (mask & (1 << ch)) {
+      count++;
+      first = ch;
+    }
+  }
+  memset(adcScanDrum, INVALID_PIN, sizeof(adcScanDrum));
+  for (int i = 0; i < validAnalog; i++) {
+    uint8_t below = mask & ((1 << (joyData[i].pin - PIN_A0)) - 1);
+    adcScanSlot[i] = 0;
+    while (below) {
+      adcScanSlot[i] += below & 1;
+      below >>= 1;
+    }
+    if (joyData[i].hasDigital) { adcScanDrum[adcScanSlot[i]] = i; }
+  }
+  adcScanCount = count;
+  adcScanTotal = ADC_SCAN_SAMPLES / count * count;
+  adcScanDrumRead = 0;
+  if (adcDataChannel < 0) {
+    adcDataChannel = dma_claim_unused_channel(true);
+    adcControlChannel = dma_claim_unused_channel(true);
+  }
+  dma_channel_config c = dma_channel_get_default_config(adcDataChannel);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, false);
+  channel_config_set_write_increment(&c, true);
+  channel_config_set_dreq(&c, DREQ_ADC);
+  channel_config_set_chain_to(&c, adcControlChannel);
+  dma_channel_configure(adcDataChannel, &c, adcScan, &adc_hw->fifo,
+                        adcScanTotal, false);
+  c = dma_channel_get_default_config(adcControlChannel);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_read_increment(&c, false);
+  channel_config_set_write_increment(&c, false);
+  dma_channel_configure(adcControlChannel, &c,
+                        &dma_hw->ch[adcDataChannel].al2_write_addr_trig,
+                        &adcScanStart, 1, false);
+  dma_channel_start(adcDataChannel);
+  adc_select_input(first);
+  adc_set_round_robin(mask);
+  adc_fifo_setup(true, true, 1, false, false);
+  adc_fifo_drain();
+  adc_set_clkdiv(0);
+  adc_run(true);
+  adcScanning = true;
+  // Wait for a full pass before anything reads the results
+  busy_wait_us_32(count * ADC_SCAN_SAMPLE_US + 2);
+}
+void stopADCScan(void) {
+  if (!adcScanning) return;
+  adc_run(false);
+  while (!(adc_hw->cs & ADC_CS_READY_BITS)) { tight_loop_contents(); }
+  // Stop the data channel from restarting the control channel, and then stop
+  // them both
+  hw_write_masked(&dma_hw->ch[adcDataChannel].al1_ctrl,
+                  adcDataChannel << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB,
+                  DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS);
+  dma_channel_abort(adcControlChannel);
+  dma_channel_abort(adcDataChannel);
+  adc_set_round_robin(0);
+  adc_fifo_setup(false, false, 0, false, false);
+  adc_fifo_drain();
+  adcScanning = false;
+}
+// How far into adcScan the DMA has got
+static uint16_t adcScanPosition(void) {
+  uint16_t pos =
+      (volatile uint16_t *)dma_hw->ch[adcDataChannel].write_addr - adcScan;
+  // Between the data channel finishing and the control channel restarting it
+  if (pos >= adcScanTotal) { pos = 0; }
+  return pos;
+}
+// Hands every drum sample taken since the last tick to drumSampled, working
+// out when each was taken from how far behind the DMA it is
+static void feedDrums(uint16_t pos) {
+  uint16_t total = adcScanTotal;
+  uint32_t now = micros();
+  uint16_t behind = (pos + total - adcScanDrumRead) % total;
+  uint8_t slot = adcScanDrumRead % adcScanCount;
+  for (uint16_t i = adcScanDrumRead; i != pos; behind--) {
+    uint8_t drum = adcScanDrum[slot];
+    if (drum != INVALID_PIN) {
+      drumSampled(drum, adcScan[i] >> 2,
+                  now - (uint32_t)behind * ADC_SCAN_SAMPLE_US);
+    }
+    if (++slot == adcScanCount) { slot = 0; }
+    if (++i == total) { i = 0; }
+  }
+  adcScanDrumRead = pos;
+}
+#endif
 void tickAnalog(void) {
   if (validAnalog == 0) return;
+#ifdef ADC_SCAN
+  if (!adcScanning) startADCScan();
+  uint16_t pos = adcScanPosition();
+  feedDrums(pos);
+  // The pass the DMA is part way through is left alone
+  uint16_t passes = adcScanTotal / adcScanCount;
+  uint16_t pass = pos / adcScanCount;
+  pass = (pass + passes - 1) % passes;
+  volatile uint16_t *values = &adcScan[pass * adcScanCount];
+#endif
   for (int i = 0; i < validAnalog; i++) {
     AnalogInfo_t *info = &joyData[i];
+#ifdef ADC_SCAN
+    int16_t data = values[adcScanSlot[i]] >> 2;
+#else
     int16_t data = analogRead(info->pin - PIN_A0);
+#endif
+    // Drums are compared against their threshold as they are
     if (!joyData[i].hasDigital) {
       data = (data - 512);
       if (info->inverted) data = -data;
+      data = data * 64;
     }
-    data = data * 64;
     info->value = data;
   }
 }
 
 uint16_t analogRead(uint8_t pin) {
+#ifdef ADC_SCAN
+  // Anything that needs a one off read (such as looking for a pin) gets the
+  // ADC to itself, and tickAnalog starts the scan again afterwards.
+  stopADCScan();
+#endif
   adc_select_input(pin);
   // We have everything coded assuming 10 bits (as that is what the arduino
   // uses) so shift accordingly (12 -> 10)
@@ -140,7 +336,13 @@ void pinMode(uint8_t pin, uint8_t mode) {
   }
 }
 
-void setupADC(void) { adc_init(); }
+void setupADC(void) {
+#ifdef ADC_SCAN
+  // joyData is about to change, so the scan gets set up again on the next tick
+  stopADCScan();
+#endif
+  adc_init();
+}
 
 void setUpValidPins(Configuration_t *config) {
   for (int i = 0; i < 6; i++) { setUpAnalogPin(config, i); }
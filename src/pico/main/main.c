@@ -12,11 +12,14 @@
 #include "output/control_requests.h"
 #include "output/descriptors.h"
 #include "output/reports.h"
+#include "output/scheduler.h"
 #include "output/serial_handler.h"
 #include "pico/stdlib.h"
 #include "pins/pins.h"
 #include "pins_arduino.h"
 #include "rf/rf.h"
+#include "stats/stats.h"
+#include "stats/trace.h"
 #include "stdbool.h"
 #include "timer/timer.h"
 #include "util/util.h"
@@ -32,9 +35,11 @@
 int validAnalog = 0;
 
 bool isRF = false;
+#ifndef BAKED_CONFIG
 bool typeIsGuitar;
 bool typeIsDrum;
 bool typeIsDJ;
+#endif
 uint8_t inputType;
 
 CFG_TUSB_MEM_SECTION CFG_TUSB_MEM_ALIGN uint8_t buf[64];
@@ -175,15 +180,21 @@ USB_Report_Data_t currentReport;
 uint8_t size;
 void hid_task(void) {
   static uint32_t start_ms = 0;
+  tickStats();
   if (isRF) {
     tickRFInput((uint8_t *)&controller, sizeof(XInput_Data_t));
   } else {
     if (!tickInputs(&controller)) {
       return;
     }
+    statsInputReady();
+    TRACE_BEGIN(TRACE_LEDS);
     tickLEDs(&controller);
+    TRACE_END(TRACE_LEDS);
   }
+  TRACE_BEGIN(TRACE_FILL_REPORT);
   fillReport(&currentReport, &size, &controller);
+  TRACE_END(TRACE_FILL_REPORT);
   if (memcmp(&currentReport, &previousReport, size) != 0) {
     uint8_t *data = (uint8_t *)&currentReport;
     uint8_t rid = *data;
@@ -191,6 +202,9 @@ void hid_task(void) {
     case REPORT_ID_XINPUT:
       if (tud_xinput_n_ready(0)) {
         tud_xinput_n_report(0, 0, data, size);
+        statsReportSent();
+        schedulerReportSent();
+        captureReportSent();
         start_ms = millis();
       }
       break;
@@ -202,6 +216,9 @@ void hid_task(void) {
       size--;
       if (tud_hid_n_ready(0)) {
         tud_hid_n_report(0, rid, data, size);
+        statsReportSent();
+        schedulerReportSent();
+        captureReportSent();
         start_ms = millis();
       }
       break;
@@ -209,6 +226,9 @@ void hid_task(void) {
       data++;
       size--;
       tud_midi_n_packet_write(0, data);
+      statsReportSent();
+      schedulerReportSent();
+      captureReportSent();
       start_ms = millis();
     }
 
@@ -228,12 +248,14 @@ void initialise(void) {
   #endif
   Configuration_t config;
   loadConfig(&config);
+#ifndef BAKED_CONFIG
   fullDeviceType = config.main.subType;
-  deviceType = fullDeviceType;
-  inputType = config.main.inputType;
   typeIsDrum = isDrum(fullDeviceType);
   typeIsGuitar = isGuitar(fullDeviceType);
   typeIsDJ = isDJ(fullDeviceType);
+#endif
+  deviceType = fullDeviceType;
+  inputType = config.main.inputType;
   if (typeIsGuitar && deviceType <= XINPUT_TURNTABLE) {
     deviceType = REAL_GUITAR_SUBTYPE;
   }
@@ -263,12 +285,13 @@ void writeToUSB(const void *const Buffer, uint8_t Length, uint8_t report,
 }
 void stopReading(void) {}
 
+void sof(uint8_t rhport) { schedulerStartOfFrame(); }
 usbd_class_driver_t driver[] = {{.init = xinputd_init,
                                  .reset = xinputd_reset,
                                  .open = xinputd_open,
                                  .control_xfer_cb = tud_vendor_control_xfer_cb,
                                  .xfer_cb = xinputd_xfer_cb,
-                                 .sof = NULL}};
+                                 .sof = sof}};
 usbd_class_driver_t const *usbd_app_driver_get_cb(uint8_t *driver_count) {
   *driver_count = 1;
   return driver;
@@ -31,9 +31,11 @@ Controller_t prevCtrl;
 long lastPoll = 0;
 int validAnalog = 0;
 uint8_t inputType;
+#ifndef BAKED_CONFIG
 bool typeIsGuitar;
 bool typeIsDrum;
 bool typeIsDJ;
+#endif
 bool isRF = false;
 void stopReading(void) {}
 
@@ -42,11 +44,13 @@ void initialise(void) {
   Configuration_t config;
   loadConfig(&config);
   config.rf.rfInEnabled = false;
+#ifndef BAKED_CONFIG
   fullDeviceType = fullDeviceType;
-  deviceType = fullDeviceType;
-  inputType = config.main.inputType;
   typeIsDrum = isDrum(fullDeviceType);
   typeIsGuitar = isGuitar(fullDeviceType);
+#endif
+  deviceType = fullDeviceType;
+  inputType = config.main.inputType;
   initInputs(&config);
   initLEDs(&config);
 }
@@ -115,11 +115,48 @@ typedef struct {
   AxisScale_t r_x;
   AxisScale_t r_y;
 } AxisScaleConfig_t;
+typedef struct {
+  // Average 1 << oversample samples together, and only filter every 1 <<
+  // oversample ticks
+  uint8_t oversample;
+  uint8_t type;
+  // In Q14. An EMA uses the first as its smoothing factor, a biquad uses all
+  // five as b0, b1, b2, a1 and a2.
+  int16_t coefficients[5];
+} AxisFilter_t;
+typedef struct {
+  AxisFilter_t lt;
+  AxisFilter_t rt;
+  AxisFilter_t l_x;
+  AxisFilter_t l_y;
+  AxisFilter_t r_x;
+  AxisFilter_t r_y;
+} AxisFilterConfig_t;
+// A curve has 1 << AXIS_CURVE_SEGMENT_BITS segments, so one more point
+#define AXIS_CURVE_SEGMENT_BITS 3
+#define AXIS_CURVE_POINTS ((1 << AXIS_CURVE_SEGMENT_BITS) + 1)
+typedef struct {
+  bool enabled;
+  // Outputs for inputs evenly spaced from INT16_MIN to INT16_MAX
+  int16_t points[AXIS_CURVE_POINTS];
+} AxisCurve_t;
+typedef struct {
+  AxisCurve_t lt;
+  AxisCurve_t rt;
+  AxisCurve_t l_x;
+  AxisCurve_t l_y;
+  AxisCurve_t r_x;
+  AxisCurve_t r_y;
+} AxisCurveConfig_t;
 
 typedef struct {
   uint8_t buttons;
   uint8_t strum;
   bool combinedStrum;
+  // Report the first edge straight away, and then ignore any changes for the
+  // debounce time, instead of waiting for the button to settle
+  bool eagerButtons;
+  bool eagerStrum;
 } DebounceConfig_t;
 
 typedef struct {
@@ -143,5 +180,9 @@ typedef struct {
   DebounceConfig_t debounce;
   NeckConfig_t neck; 
   bool deque;
+  AxisFilterConfig_t axisFilter;
+  AxisCurveConfig_t axisCurve;
+  // One bit per axis, in the same order as axisScale
+  uint8_t autoCalibrate;
 } Configuration_t;
 #pragma pack(pop)
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 #include "../leds/led_colours.h"
 #include "./defines.h"
-#define CONFIG_VERSION 18
+#define CONFIG_VERSION 22
 #define TILT_SENSOR NONE
 #define DEVICE_TYPE DIRECT
 #define OUTPUT_TYPE XINPUT_GUITAR_HERO_GUITAR
@@ -89,11 +89,31 @@
         DEFAULT_AXIS_SCALE                                                     \
   }
   #define DEFAULT_NECK {false, false, false, false, false}
+#define DEFAULT_AXIS_FILTER                                                    \
+  { 0, FILTER_NONE, {0} }
+#define DEFAULT_AXIS_FILTERS                                                   \
+  {                                                                            \
+    DEFAULT_AXIS_FILTER, DEFAULT_AXIS_FILTER, DEFAULT_AXIS_FILTER,             \
+        DEFAULT_AXIS_FILTER, DEFAULT_AXIS_FILTER, DEFAULT_AXIS_FILTER          \
+  }
+// A straight line, so turning a curve on before setting it up changes nothing
+#define DEFAULT_AXIS_CURVE                                                     \
+  {                                                                            \
+    false, {                                                                   \
+      INT16_MIN, -24576, -16384, -8192, 0, 8192, 16384, 24576, INT16_MAX       \
+    }                                                                          \
+  }
+#define DEFAULT_AXIS_CURVES                                                    \
+  {                                                                            \
+    DEFAULT_AXIS_CURVE, DEFAULT_AXIS_CURVE, DEFAULT_AXIS_CURVE,                \
+        DEFAULT_AXIS_CURVE, DEFAULT_AXIS_CURVE, DEFAULT_AXIS_CURVE             \
+  }
 #define DEFAULT_DEBOUNCE                                                       \
-  { BUTTON_DEBOUNCE, STRUM_DEBOUNCE, false }
+  { BUTTON_DEBOUNCE, STRUM_DEBOUNCE, false, true, true }
 #define DEFAULT_CONFIG                                                         \
   {                                                                            \
     DEFAULT_CONFIG_MAIN, PINS, DEFAULT_THRESHOLDS, KEYS, LED_PINS,             \
         DEFAULT_MIDI, {false}, INVALID_PIN, DEFAULT_AXIS_SCALES,               \
-        DEFAULT_DEBOUNCE, DEFAULT_NECK, false                                                       \
+        DEFAULT_DEBOUNCE, DEFAULT_NECK, false, DEFAULT_AXIS_FILTERS,           \
+        DEFAULT_AXIS_CURVES, 0                                                 \
   }
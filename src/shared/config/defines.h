@@ -4,7 +4,7 @@
 #define REAL_GUITAR_SUBTYPE 7
 #define REAL_DRUM_SUBTYPE 8
 // Tilt detection
-enum TiltType { NO_TILT, MPU_6050, DIGITAL, ANALOGUE };
+enum TiltType { NO_TILT, MPU_6050, DIGITAL, ANALOGUE, MOTION_PLUS };
 
 // Input types
 enum InputType { WII = 1, DIRECT, PS2 };
@@ -72,6 +72,9 @@ enum FretLedMode { LEDS_DISABLED, LEDS_INLINE, APA102 };
 
 enum MidiType { DISABLED, NOTE, CONTROL_COMMAND };
 
+// Filters that can be run over an analog axis
+enum FilterType { FILTER_NONE, FILTER_EMA, FILTER_BIQUAD };
+
 enum PinTypeFlags {
   DIGITAL_PIN,
   ANALOGUE_PIN,
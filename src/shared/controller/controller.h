@@ -3,7 +3,6 @@
 
 #define XBOX_BTN_COUNT 16
 #define XBOX_AXIS_COUNT 6
-#define BUFFER_SIZE_QUEUE 255
 extern uint16_t wiiExtensionID;
 extern uint8_t ps2CtrlType;
 typedef struct {
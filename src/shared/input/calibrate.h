@@ -0,0 +1,166 @@
+#pragma once
+#include "config/config.h"
+#include "controller/controller.h"
+#include "eeprom/eeprom.h"
+#include "timer/timer.h"
+#include "util/util.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+// Axes with their bit set in autoCalibrate keep recalibrating themselves while
+// they are used, so that a pot that has drifted or worn doesn't need to be set
+// up again with the configurator. The lowest and highest values seen since
+// power on are tracked, and for sticks so is where the axis comes to rest, and
+// the scale is worked out from those instead of from the config.
+//
+// The learned range starts out empty every time, so that it can shrink as well
+// as grow, and it is only used once it covers at least half of what the
+// configured scale does, so just plugging the controller in doesn't throw away
+// a good calibration. The new scale is saved so the next power on starts from
+// it, but only once every calibrating axis has been sitting still for a while,
+// as saving blocks (for a few ms on the avr, and longer on the pico as it
+// rewrites flash) and shouldn't land in the middle of play.
+//
+// This works on the filtered value, so a noisy pot should have a filter set up
+// as well, or a single spike can stretch the range.
+//
+// A baked config can't be changed, so there is nothing to calibrate.
+#ifndef BAKED_CONFIG
+// A range smaller than 32 adc steps is more likely a broken pot
+#  define CALIBRATE_MIN_SPAN 2048
+// An axis has to stay within 4 adc steps for a second to be at rest
+#  define CALIBRATE_REST_WINDOW 256
+#  define CALIBRATE_REST_MS 1000
+// How long every calibrating axis has to be at rest for before saving
+#  define CALIBRATE_SETTLE_MS 10000
+typedef struct {
+  int16_t min;
+  int16_t max;
+  int16_t centre;
+  // Where the axis is sitting, and since when
+  int16_t rest;
+  uint32_t restSince;
+  // The smallest span that will replace the configured scale
+  int32_t minSpan;
+  bool started;
+  bool centred;
+  bool active;
+  bool dirty;
+} AxisCalibration_t;
+uint8_t calibrating;
+AxisCalibration_t calibrations[XBOX_AXIS_COUNT];
+// The scales being used, which is what gets saved
+AxisScale_t *calibrationScales;
+void initCalibration(Configuration_t *config, AxisScale_t *scales) {
+  calibrating = config->autoCalibrate;
+  calibrationScales = scales;
+  for (uint8_t i = 0; i < XBOX_AXIS_COUNT; i++) {
+    AxisCalibration_t *cal = &calibrations[i];
+    memset(cal, 0, sizeof(AxisCalibration_t));
+    cal->minSpan = CALIBRATE_MIN_SPAN;
+    if (scales[i].multiplier > 0) {
+      int32_t span = (65536L * 1024 / scales[i].multiplier) / 2;
+      if (span > cal->minSpan) { cal->minSpan = span; }
+    }
+  }
+}
+// Writes every axis that has changed, and then stores them all at once, as on
+// the pico every commit rewrites the whole flash sector
+static void saveCalibration(void) {
+  for (uint8_t i = 0; i < XBOX_AXIS_COUNT; i++) {
+    if (!calibrations[i].dirty) continue;
+    writeConfigBlock(offsetof(Configuration_t, axisScale) +
+                         i * sizeof(AxisScale_t),
+                     (const uint8_t *)&calibrationScales[i],
+                     sizeof(AxisScale_t));
+    calibrations[i].dirty = false;
+  }
+  commitConfig();
+}
+// Works out the scale from what has been learned, if it is enough to go on.
+// Sticks are scaled so that the rest position is in the middle, using the
+// shorter side, so that both directions still reach full deflection.
+static bool updateScale(AxisCalibration_t *cal, AxisScale_t *scale,
+                        bool trigger) {
+  int32_t offset, span;
+  if (trigger) {
+    offset = cal->min;
+    span = (int32_t)cal->max - cal->min;
+  } else {
+    if (!cal->centred) return false;
+    int32_t half = (int32_t)cal->centre - cal->min;
+    if ((int32_t)cal->max - cal->centre < half) {
+      half = (int32_t)cal->max - cal->centre;
+    }
+    offset = cal->centre - half;
+    span = half * 2;
+  }
+  if (span < cal->minSpan) return false;
+  int32_t multiplier = 65536L * 1024 / span;
+  if (multiplier > INT16_MAX) { multiplier = INT16_MAX; }
+  if (scale->offset == offset && scale->multiplier == multiplier) return true;
+  scale->offset = offset;
+  scale->multiplier = multiplier;
+  cal->dirty = true;
+  return true;
+}
+// True once every calibrating axis that has been read is at rest, and has
+// been for long enough that nobody is playing
+static bool calibrationSettled(uint32_t now) {
+  for (uint8_t i = 0; i < XBOX_AXIS_COUNT; i++) {
+    AxisCalibration_t *cal = &calibrations[i];
+    if (!bit_check(calibrating, i) || !cal->started) continue;
+    if (now - cal->restSince < CALIBRATE_SETTLE_MS) return false;
+  }
+  return true;
+}
+void calibrateAxis(uint8_t axis, int16_t value, AxisScale_t *scale,
+                   bool trigger) {
+  if (!bit_check(calibrating, axis)) return;
+  AxisCalibration_t *cal = &calibrations[axis];
+  uint32_t now = millis();
+  bool moved = false;
+  if (!cal->started) {
+    cal->min = cal->max = cal->rest = value;
+    cal->restSince = now;
+    cal->started = true;
+    moved = true;
+  }
+  if (value < cal->min) {
+    cal->min = value;
+    moved = true;
+  }
+  if (value > cal->max) {
+    cal->max = value;
+    moved = true;
+  }
+  if (abs(value - cal->rest) > CALIBRATE_REST_WINDOW) {
+    cal->rest = value;
+    cal->restSince = now;
+  } else if (!trigger) {
+    if (now - cal->restSince > CALIBRATE_REST_MS &&
+        (!cal->centred || cal->rest != cal->centre)) {
+      // A stick being held over to one side isn't at rest, so only accept
+      // somewhere in the middle half of the range
+      int32_t quarter = ((int32_t)cal->max - cal->min) / 4;
+      if (cal->rest > cal->min + quarter && cal->rest < cal->max - quarter) {
+        cal->centre = cal->rest;
+        cal->centred = true;
+        moved = true;
+      }
+    }
+  }
+  if (moved) { cal->active |= updateScale(cal, scale, trigger); }
+  if (cal->active && cal->dirty && calibrationSettled(now)) {
+    saveCalibration();
+  }
+}
+#  define CALIBRATE_INIT(config, scales) initCalibration(config, scales)
+#  define CALIBRATE_AXIS(axis, value, scale, trigger)                         \
+    calibrateAxis(axis, value, scale, trigger)
+#else
+#  define CALIBRATE_INIT(config, scales)
+#  define CALIBRATE_AXIS(axis, value, scale, trigger)
+#endif
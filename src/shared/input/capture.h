@@ -0,0 +1,121 @@
+#pragma once
+#include "config/config.h"
+#include "debounce.h"
+#include "inputs/direct.h"
+#include "pins/pins.h"
+#include "timer/timer.h"
+#include "util/util.h"
+#include <stdint.h>
+#include <string.h>
+// Build with CAPTURE_EDGES defined to also capture edges on direct buttons from
+// pin change interrupts, instead of only seeing whatever level the pins happen
+// to be at when the main loop gets around to sampling them. Every edge is
+// stamped with the time it happened, and they are all run through the
+// debouncer in order before the tick's own sample. Any press the debouncer
+// accepts is then held until it has been sent in a report, so taps that are
+// shorter than a tick (or a slow i2c read) still make it to the host.
+//
+// Pins that can't raise a pin change interrupt are just sampled as usual.
+#ifdef CAPTURE_EDGES
+#  ifdef __AVR__
+#    define CAPTURE_SIZE 16
+#  else
+#    define CAPTURE_SIZE 64
+#  endif
+typedef struct {
+  uint32_t time;
+  uint8_t port;
+  port_t value;
+} CaptureEvent_t;
+volatile CaptureEvent_t captureEvents[CAPTURE_SIZE];
+volatile uint8_t captureHead;
+volatile uint8_t captureCount;
+// Buttons on pins that raise pin change interrupts
+uint16_t captureButtons;
+// The sampled ports as of the last edge that was replayed
+port_t captureValues[XBOX_BTN_COUNT];
+// Presses that haven't been sent yet, what tickInputs last handed out for a
+// report, and what was actually sent last
+uint16_t captureLatched;
+uint16_t capturePending;
+uint16_t captureReported;
+void pinChanged(uint8_t port, port_t value) {
+  // Anything that doesn't fit is still picked up by the next sample
+  if (captureCount == CAPTURE_SIZE) return;
+  volatile CaptureEvent_t *event =
+      &captureEvents[(captureHead + captureCount) % CAPTURE_SIZE];
+  event->time = micros();
+  event->port = port;
+  event->value = value;
+  captureCount++;
+}
+void initCapture(Configuration_t *config) {
+  captureButtons = 0;
+  captureLatched = 0;
+  capturePending = 0;
+  captureReported = 0;
+  cli();
+  captureHead = 0;
+  captureCount = 0;
+  sei();
+  if (CONFIG_INPUT_TYPE(config) != DIRECT) return;
+  for (uint8_t i = 0; i < validPins; i++) {
+    Pin_t *pin = &pinData[i];
+    if (pin->analogOffset == INVALID_PIN && enablePinChange(pin)) {
+      bit_set(captureButtons, pin->offset);
+    }
+  }
+  samplePins();
+  memcpy(captureValues, sampleValues, sizeof(captureValues));
+}
+// raw is the state of every button for this tick, and is used for the buttons
+// that aren't captured.
+void replayCapturedEdges(uint16_t raw) {
+  while (true) {
+    cli();
+    if (!captureCount) {
+      sei();
+      break;
+    }
+    volatile CaptureEvent_t *event = &captureEvents[captureHead];
+    uint32_t time = event->time;
+    uint8_t port = event->port;
+    port_t value = event->value;
+    captureHead = (captureHead + 1) % CAPTURE_SIZE;
+    captureCount--;
+    sei();
+    // Catch the debouncer up to the edge with the buttons as they were, and
+    // then show it the edge itself
+    uint16_t buttons = (raw & ~captureButtons) |
+                       (portsToButtons(captureValues) & captureButtons);
+    captureLatched |= debounceAt(buttons, time) & ~captureReported;
+    for (uint8_t i = 0; i < samplePortCount; i++) {
+      if (samplePorts[i] == port) { captureValues[i] = value; }
+    }
+    buttons = (raw & ~captureButtons) |
+              (portsToButtons(captureValues) & captureButtons);
+    captureLatched |= debounceAt(buttons, time) & ~captureReported;
+  }
+  memcpy(captureValues, sampleValues, sizeof(captureValues));
+}
+// Only called once a report has gone out, as the endpoint can still be busy
+// after tickInputs says one is due, and a latched press has to wait for it
+void captureReportSent(void) {
+  captureReported = capturePending;
+  captureLatched = 0;
+}
+#  define CAPTURE_INIT(config) initCapture(config)
+#  define CAPTURE_REPLAY(raw) replayCapturedEdges(raw)
+#  define CAPTURE_LATCH(buttons)                                              \
+    do {                                                                       \
+      captureLatched |= (buttons) & ~captureReported;                         \
+      (buttons) |= captureLatched;                                             \
+    } while (0)
+#  define CAPTURE_PENDING(buttons) capturePending = (buttons)
+#else
+void captureReportSent(void) {}
+#  define CAPTURE_INIT(config)
+#  define CAPTURE_REPLAY(raw)
+#  define CAPTURE_LATCH(buttons)
+#  define CAPTURE_PENDING(buttons)
+#endif
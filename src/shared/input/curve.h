@@ -0,0 +1,31 @@
+#pragma once
+#include "config/config.h"
+#include "controller/controller.h"
+#include <stdint.h>
+#include <string.h>
+// Optional response curves, applied to an axis after it has been scaled and
+// had its deadzone applied. A curve is a small table of outputs for inputs
+// spread evenly across the whole int16 range, so the first point is what
+// INT16_MIN maps to and the last is what INT16_MAX maps to, and everything in
+// between is linearly interpolated between the two nearest points.
+//
+// Spacing the points evenly means finding the segment is a shift and the
+// interpolation is a single multiply, with no division, so a curve costs about
+// the same as the scaling does.
+#define CURVE_SEGMENT_SHIFT (16 - AXIS_CURVE_SEGMENT_BITS)
+AxisCurve_t curves[XBOX_AXIS_COUNT];
+void initCurves(Configuration_t *config) {
+  memcpy(curves, &config->axisCurve, sizeof(curves));
+}
+int16_t curveAxis(uint8_t axis, int16_t value) {
+  AxisCurve_t *curve = &curves[axis];
+  if (!curve->enabled) return value;
+  // Otherwise the top of the last segment is one step short of the last point
+  if (value == INT16_MAX) return curve->points[AXIS_CURVE_POINTS - 1];
+  uint16_t pos = value - INT16_MIN;
+  uint8_t idx = pos >> CURVE_SEGMENT_SHIFT;
+  int32_t frac = pos & ((1 << CURVE_SEGMENT_SHIFT) - 1);
+  int16_t y0 = curve->points[idx];
+  int32_t dy = curve->points[idx + 1] - y0;
+  return y0 + ((dy * frac) >> CURVE_SEGMENT_SHIFT);
+}
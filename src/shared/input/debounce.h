@@ -0,0 +1,102 @@
+#pragma once
+#include "config/config.h"
+#include "controller/controller.h"
+#include "timer/timer.h"
+#include "util/util.h"
+#include <stdint.h>
+// Debounces all the buttons at once using vertical counters. Every button gets
+// an 8 bit counter, but the counters are stored sliced up by bit, so that
+// debounceCount[n] holds bit n of every button's counter. A button changes
+// state once it has read differently for as long as its threshold, and its
+// counter is reset whenever it reads the same as its current state.
+//
+// Buttons can instead be set to eager, where the first change is reported
+// straight away and the counter becomes a lockout timer instead. An eager
+// button always counts, its counter is reset when it changes state, and any
+// changes are ignored until it reaches the threshold again.
+//
+// When strum is merged the strum directions count together, and a change on
+// either of them restarts both, so that one direction can't change straight
+// after the other has.
+//
+// Thresholds are in the same 100us units as the config, and time is counted
+// once per tick rather than once per pin.
+#define DEBOUNCE_PLANES 8
+#define DEBOUNCE_UNIT_US 100
+uint16_t debounceCount[DEBOUNCE_PLANES];
+uint16_t debounceThreshold[DEBOUNCE_PLANES];
+uint16_t debounced;
+uint16_t debounceMerged;
+uint16_t debounceEager;
+uint32_t lastDebounce;
+void initDebounce(Configuration_t *config, bool mergedStrum) {
+  uint16_t strum = 0;
+  if (typeIsGuitar) { strum = _BV(XBOX_DPAD_UP) | _BV(XBOX_DPAD_DOWN); }
+  for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) {
+    debounceCount[i] = 0;
+    debounceThreshold[i] = 0;
+    if (bit_check(config->debounce.buttons, i)) {
+      debounceThreshold[i] |= ~strum;
+    }
+    if (bit_check(config->debounce.strum, i)) {
+      debounceThreshold[i] |= strum;
+    }
+  }
+  debounceMerged = mergedStrum ? strum : 0;
+  debounceEager = 0;
+  if (config->debounce.eagerButtons) { debounceEager |= ~strum; }
+  if (config->debounce.eagerStrum) { debounceEager |= strum; }
+  debounced = 0;
+  lastDebounce = 0;
+}
+// Takes the raw state of every button as of now, and returns the debounced
+// state
+uint16_t debounceAt(uint16_t raw, uint32_t now) {
+  int32_t elapsed = now - lastDebounce;
+  uint8_t units;
+  if (elapsed < 0) {
+    // Captured edges can land just before the last tick read the time
+    units = 0;
+  } else if (elapsed >= UINT8_MAX * DEBOUNCE_UNIT_US) {
+    // Long enough for any threshold
+    units = UINT8_MAX;
+    lastDebounce = now;
+  } else {
+    units = (uint16_t)elapsed / DEBOUNCE_UNIT_US;
+    // Keep the remainder, so that fast ticks still add up
+    lastDebounce += units * DEBOUNCE_UNIT_US;
+  }
+  uint16_t changed = raw ^ debounced;
+  uint16_t counting = changed | debounceEager;
+  if (changed & debounceMerged) { counting |= debounceMerged; }
+  // Add units to every counter that is counting, and reset the rest
+  uint16_t carry = 0;
+  for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) {
+    uint16_t count = debounceCount[i] & counting;
+    uint16_t add = bit_check(units, i) ? counting : 0;
+    debounceCount[i] = count ^ add ^ carry;
+    carry = (count & add) | (carry & (count ^ add));
+  }
+  // Counters that overflowed are well past any threshold
+  for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) { debounceCount[i] |= carry; }
+  // Compare every counter against its threshold, starting from the top bit
+  uint16_t greater = 0;
+  uint16_t equal = 0xFFFF;
+  for (int8_t i = DEBOUNCE_PLANES - 1; i >= 0; i--) {
+    greater |= equal & debounceCount[i] & ~debounceThreshold[i];
+    equal &= ~(debounceCount[i] ^ debounceThreshold[i]);
+  }
+  uint16_t toggled = (greater | equal) & changed;
+  debounced ^= toggled;
+  // Start the lockout for any eager buttons that just changed, and restart
+  // every merged button when one of them does
+  uint16_t restart = toggled & debounceEager;
+  if (toggled & debounceMerged) { restart |= debounceMerged; }
+  if (restart) {
+    for (uint8_t i = 0; i < DEBOUNCE_PLANES; i++) {
+      debounceCount[i] &= ~restart;
+    }
+  }
+  return debounced;
+}
+uint16_t tickDebounce(uint16_t raw) { return debounceAt(raw, micros()); }
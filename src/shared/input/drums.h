@@ -0,0 +1,135 @@
+#pragma once
+#include "eeprom/eeprom.h"
+#include "pins/pins.h"
+#include "timer/timer.h"
+#include "util/util.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+// Drum pads wired to analog pins (see setUpAnalogDigitalPin) are run through a
+// small trigger detector, which is fed every sample the platform takes of
+// them. With ADC_SCAN that is every conversion the background scan makes
+// (from the ADC interrupt on the avr, or out of the DMA ring on the pico),
+// otherwise it is just the one sample tickAnalog takes each tick.
+//
+// A hit starts once a pad goes over its threshold. With ADC_SCAN the highest
+// sample over the next DRUM_SCAN_US is used for its velocity, instead of
+// whatever the pad happened to read when it crossed. Without it there aren't
+// any more samples to look at in that time (the avr only reads one channel a
+// tick), so the hit is reported straight away. After that the pad ignores
+// itself for DRUM_MASK_US, so that the head ringing doesn't retrigger it.
+// Hitting one pad also shakes the ones around it, so a hit is dropped if
+// another pad was hit at least twice as hard at the same time.
+//
+// The pico scans far faster than a hit changes, so with ADC_SCAN each pad only
+// runs the detector once every DRUM_SAMPLE_US, on the highest sample it saw in
+// that time, so that no peak is lost.
+#define DRUM_SCAN_US 1500
+#define DRUM_SAMPLE_US 100
+#define DRUM_MASK_US 15000
+// How long a hit holds its button down for, so that it makes it into a report
+#define DRUM_HOLD_US 10000
+#define DRUM_XTALK_US 3000
+// A hit has to be at least 1 / (1 << DRUM_XTALK_SHIFT) of the hardest hit
+// around it to count
+#define DRUM_XTALK_SHIFT 1
+enum DrumState { DRUM_IDLE, DRUM_SCANNING, DRUM_MASKED };
+typedef struct {
+  uint8_t state;
+  uint16_t peak;
+#ifdef ADC_SCAN
+  // The highest sample since windowStart
+  uint16_t windowPeak;
+  uint32_t windowStart;
+#endif
+  // When the current hit started, which the mask is timed from
+  uint32_t since;
+  // Written by whatever feeds the samples in, which may be an interrupt
+  volatile uint8_t hits;
+  volatile uint8_t velocity;
+  // Only touched by tickDrums
+  uint8_t seen;
+  bool held;
+  uint32_t heldAt;
+} DrumPad_t;
+DrumPad_t drumPads[NUM_ANALOG_INPUTS];
+// The last hit that was let through, on any pad
+uint16_t drumLastPeak;
+uint32_t drumLastHit;
+void initDrums(void) {
+  memset(drumPads, 0, sizeof(drumPads));
+  drumLastPeak = 0;
+}
+static bool isCrossTalk(uint8_t analog, uint16_t peak, uint32_t now) {
+  if (now - drumLastHit < DRUM_XTALK_US &&
+      peak < (drumLastPeak >> DRUM_XTALK_SHIFT)) {
+    return true;
+  }
+  // A harder hit on another pad may not have finished its scan yet
+  for (uint8_t i = 0; i < validAnalog; i++) {
+    if (i != analog && drumPads[i].state == DRUM_SCANNING &&
+        peak < (drumPads[i].peak >> DRUM_XTALK_SHIFT)) {
+      return true;
+    }
+  }
+  return false;
+}
+// Masks the pad, and reports its peak as a hit unless it is cross talk
+static void drumHit(uint8_t analog, DrumPad_t *pad, uint32_t now) {
+  pad->state = DRUM_MASKED;
+  if (isCrossTalk(analog, pad->peak, now)) return;
+  drumLastPeak = pad->peak;
+  drumLastHit = now;
+  pad->velocity = pad->peak >> 2;
+  pad->hits++;
+}
+// analog is the index into joyData, and value is the raw 10 bit sample
+void drumSampled(uint8_t analog, uint16_t value, uint32_t now) {
+  DrumPad_t *pad = &drumPads[analog];
+#ifdef ADC_SCAN
+  if (value > pad->windowPeak) { pad->windowPeak = value; }
+  if (now - pad->windowStart < DRUM_SAMPLE_US) return;
+  value = pad->windowPeak;
+  pad->windowPeak = 0;
+  pad->windowStart = now;
+#endif
+  switch (pad->state) {
+  case DRUM_MASKED:
+    if (now - pad->since < DRUM_MASK_US) return;
+    pad->state = DRUM_IDLE;
+    // fall through
+  case DRUM_IDLE:
+    if (value <= joyData[analog].threshold) return;
+    pad->peak = value;
+    pad->since = now;
+#ifdef ADC_SCAN
+    pad->state = DRUM_SCANNING;
+#else
+    drumHit(analog, pad, now);
+#endif
+    return;
+  case DRUM_SCANNING:
+    if (value > pad->peak) { pad->peak = value; }
+    if (now - pad->since < DRUM_SCAN_US) return;
+    drumHit(analog, pad, now);
+    return;
+  }
+}
+// Picks up any new hits on the pads in pins, and presses their buttons
+void tickDrums(Pin_t **pins, uint8_t count) {
+  uint32_t now = micros();
+  for (uint8_t i = 0; i < count; i++) {
+    Pin_t *pin = pins[i];
+    DrumPad_t *pad = &drumPads[pin->analogOffset];
+    uint8_t hits = pad->hits;
+    if (hits != pad->seen) {
+      pad->seen = hits;
+      drumVelocity[pin->offset - 8] = pad->velocity;
+      pad->held = true;
+      pad->heldAt = now;
+    } else if (pad->held && now - pad->heldAt > DRUM_HOLD_US) {
+      pad->held = false;
+    }
+  }
+}
+bool drumHeld(Pin_t *pin) { return drumPads[pin->analogOffset].held; }
@@ -0,0 +1,116 @@
+#pragma once
+#include "config/config.h"
+#include "controller/controller.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+// Filters each analog axis after tickAnalog, before it is scaled, so that a
+// noisy pot doesn't change the report (and force a transfer) on every tick.
+// Oversampling sums up 1 << oversample ticks worth of samples and only passes
+// on the average, and then the result can be smoothed with a one pole EMA or a
+// biquad. Everything is integer math, with Q14 coefficients.
+//
+// The biquad runs on the value shifted down by 2, which still keeps the full
+// resolution of a 12 bit adc, so that the accumulator can't overflow whatever
+// the coefficients are.
+#define FILTER_Q 14
+#define FILTER_BIQUAD_SHIFT 2
+// The EMA keeps this many fractional bits, so small factors don't stall
+#define FILTER_EMA_FRAC 4
+// Any more than 64 samples wouldn't fit in the counter anyway
+#define FILTER_MAX_OVERSAMPLE 6
+// The output only follows the filter once it has moved by a whole adc step
+// (tickAnalog scales 10 bit samples up by 64), so that whatever noise is left
+// after filtering doesn't still change the report on every tick.
+#define FILTER_HYSTERESIS 64
+typedef struct {
+  int32_t sum;
+  uint8_t count;
+  bool primed;
+  int16_t out;
+  union {
+    int32_t ema;
+    struct {
+      int16_t x1, x2, y1, y2;
+      // What was cut off the last output, fed back in so that the output
+      // doesn't get stuck short of where the input settled
+      int16_t error;
+    } biquad;
+  };
+} AxisFilterState_t;
+AxisFilter_t filters[XBOX_AXIS_COUNT];
+AxisFilterState_t filterStates[XBOX_AXIS_COUNT];
+void initFilters(Configuration_t *config) {
+  memcpy(filters, &config->axisFilter, sizeof(filters));
+  memset(filterStates, 0, sizeof(filterStates));
+  for (uint8_t i = 0; i < XBOX_AXIS_COUNT; i++) {
+    if (filters[i].oversample > FILTER_MAX_OVERSAMPLE) {
+      filters[i].oversample = FILTER_MAX_OVERSAMPLE;
+    }
+  }
+}
+int16_t runFilter(AxisFilter_t *filter, AxisFilterState_t *state,
+                  int16_t value) {
+  switch (filter->type) {
+  case FILTER_EMA: {
+    // Start from the first sample instead of from 0
+    if (!state->primed) {
+      state->ema = (int32_t)value * (1 << FILTER_EMA_FRAC);
+    }
+    int32_t diff = value - (state->ema >> FILTER_EMA_FRAC);
+    state->ema += (diff * filter->coefficients[0]) >>
+                  (FILTER_Q - FILTER_EMA_FRAC);
+    return state->ema >> FILTER_EMA_FRAC;
+  }
+  case FILTER_BIQUAD: {
+    int16_t x = value >> FILTER_BIQUAD_SHIFT;
+    if (!state->primed) {
+      state->biquad.x1 = state->biquad.x2 = x;
+      state->biquad.y1 = state->biquad.y2 = x;
+      state->biquad.error = 0;
+    }
+    int16_t *c = filter->coefficients;
+    int32_t acc = (int32_t)c[0] * x + (int32_t)c[1] * state->biquad.x1 +
+                  (int32_t)c[2] * state->biquad.x2 -
+                  (int32_t)c[3] * state->biquad.y1 -
+                  (int32_t)c[4] * state->biquad.y2 + state->biquad.error;
+    state->biquad.error = acc & ((1 << FILTER_Q) - 1);
+    acc >>= FILTER_Q;
+    int16_t max = INT16_MAX >> FILTER_BIQUAD_SHIFT;
+    int16_t min = INT16_MIN >> FILTER_BIQUAD_SHIFT;
+    if (acc > max) acc = max;
+    if (acc < min) acc = min;
+    state->biquad.x2 = state->biquad.x1;
+    state->biquad.x1 = x;
+    state->biquad.y2 = state->biquad.y1;
+    state->biquad.y1 = acc;
+    return acc * (1 << FILTER_BIQUAD_SHIFT);
+  }
+  }
+  return value;
+}
+// Called every tick with the latest sample for an axis, and returns the value
+// to scale.
+int16_t filterAxis(uint8_t axis, int16_t value) {
+  AxisFilter_t *filter = &filters[axis];
+  AxisFilterState_t *state = &filterStates[axis];
+  if (filter->oversample) {
+    state->sum += value;
+    if (++state->count < (1 << filter->oversample) && state->primed) {
+      return state->out;
+    }
+    value = state->sum >> (state->primed ? filter->oversample : 0);
+    state->sum = 0;
+    state->count = 0;
+  } else if (filter->type == FILTER_NONE) {
+    return value;
+  }
+  int16_t filtered = runFilter(filter, state, value);
+  int32_t moved = (int32_t)filtered - state->out;
+  if (!state->primed || moved >= FILTER_HYSTERESIS ||
+      moved <= -FILTER_HYSTERESIS) {
+    state->out = filtered;
+  }
+  state->primed = true;
+  return state->out;
+}
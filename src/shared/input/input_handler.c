@@ -1,6 +1,8 @@
 #include "input_handler.h"
 #include "eeprom/eeprom.h"
 #include "i2c/i2c.h"
+#include "capture.h"
+#include "debounce.h"
 #include "inputs/direct.h"
 #include "inputs/dj.h"
 #include "inputs/guitar.h"
@@ -8,12 +10,18 @@
 #include "inputs/wii_ext.h"
 #include "leds/leds.h"
 #include "output/descriptors.h"
+#include "output/scheduler.h"
 #include "pins/pins.h"
+#include "queue.h"
 #include "spi/spi.h"
+#include "stats/record.h"
+#include "stats/trace.h"
 #include "util/util.h"
 #include <stdlib.h>
 void (*tick_function)(Controller_t *);
 bool (*read_button_function)(Pin_t *pin);
+uint16_t (*read_buttons_function)(void);
+uint16_t (*read_raw_function)(void);
 int joyThreshold;
 int triggerThreshold;
 bool mapJoyLeftDpad;
@@ -21,17 +29,98 @@ bool mapStartSelectHome;
 bool mergedStrum;
 bool ghDrum = false;
 bool queueEnabled;
-long lastPollBuf = 0;
-uint8_t lastQueue;
 uint32_t pollRate;
-uint8_t queue[BUFFER_SIZE_QUEUE];
-uint8_t queueSize = 0;
-uint8_t queueTail = 0;
 Pin_t pinData[XBOX_BTN_COUNT] = {};
 Pin_t euphoriaPin;
-Pin_t *downStrumPin;
+bool hasEuphoria;
+// Every button that has a pin bound to it
+uint16_t boundButtons;
 uint16_t dpad_bits = ~(_BV(XBOX_DPAD_UP) | _BV(XBOX_DPAD_DOWN) |
                        _BV(XBOX_DPAD_LEFT) | _BV(XBOX_DPAD_RIGHT));
+// tickInputs just runs through a list of steps, built by initInputs to only
+// contain the ones that the current config actually needs.
+typedef void (*InputStep_t)(Controller_t *controller);
+#define MAX_INPUT_STEPS 12
+InputStep_t inputPlan[MAX_INPUT_STEPS];
+uint8_t inputPlanLength;
+// The debounced state of every bound button, as of this tick
+uint16_t tickButtons;
+uint16_t readPinButtons(void) {
+  uint16_t buttons = 0;
+  for (uint8_t i = 0; i < validPins; i++) {
+    if (read_button_function(&pinData[i])) { bit_set(buttons, pinData[i].offset); }
+  }
+  return buttons;
+}
+// With DJ controllers, euphoria and y are going to different pins but are
+// the same output.
+uint16_t readEuphoriaButtons(void) {
+  uint16_t buttons = read_buttons_function();
+  if (read_button_function(&euphoriaPin)) { bit_set(buttons, XBOX_Y); }
+  return buttons;
+}
+void stepClearTilt(Controller_t *controller) { controller->r_y = 0; }
+void stepTickFunction(Controller_t *controller) {
+  TRACE_BEGIN(TRACE_TICK_FUNCTION);
+  tick_function(controller);
+  TRACE_END(TRACE_TICK_FUNCTION);
+}
+void stepDirect(Controller_t *controller) {
+  TRACE_BEGIN(TRACE_DIRECT_INPUT);
+  tickDirectInput(controller);
+  TRACE_END(TRACE_DIRECT_INPUT);
+}
+void stepButtons(Controller_t *controller) {
+  uint16_t raw = read_raw_function() & boundButtons;
+  CAPTURE_REPLAY(raw);
+  uint16_t buttons = tickDebounce(raw);
+  CAPTURE_LATCH(buttons);
+  tickButtons = buttons;
+  controller->buttons = (controller->buttons & ~boundButtons) | buttons;
+}
+void stepStartSelectHome(Controller_t *controller) {
+  if (bit_check(tickButtons, XBOX_START) && bit_check(tickButtons, XBOX_BACK)) {
+    bit_set(controller->buttons, XBOX_HOME);
+    bit_clear(controller->buttons, XBOX_START);
+    bit_clear(controller->buttons, XBOX_BACK);
+  } else {
+    bit_clear(controller->buttons, XBOX_HOME);
+  }
+}
+void stepJoyDpad(Controller_t *controller) {
+  // Reset any bits that were not touched above (aka any unbound directions)
+  controller->buttons &= dpad_bits;
+  CHECK_JOY(l_x, XBOX_DPAD_LEFT, XBOX_DPAD_RIGHT);
+  CHECK_JOY(l_y, XBOX_DPAD_DOWN, XBOX_DPAD_UP);
+}
+void stepGuitar(Controller_t *controller) {
+  TRACE_BEGIN(TRACE_GUITAR);
+  tickGuitar(controller);
+  TRACE_END(TRACE_GUITAR);
+}
+void stepDJ(Controller_t *controller) {
+  TRACE_BEGIN(TRACE_DJ);
+  tickDJ(controller);
+  TRACE_END(TRACE_DJ);
+}
+void stepGHDrum(Controller_t *controller) {
+  bit_set(controller->buttons, XBOX_LEFT_STICK);
+}
+void stepQueue(Controller_t *controller) { pushQueue(tickButtons >> 8); }
+void addStep(InputStep_t step) { inputPlan[inputPlanLength++] = step; }
+void buildInputPlan(void) {
+  inputPlanLength = 0;
+  if (typeIsGuitar) { addStep(stepClearTilt); }
+  if (tick_function) { addStep(stepTickFunction); }
+  addStep(stepDirect);
+  addStep(stepButtons);
+  if (mapStartSelectHome) { addStep(stepStartSelectHome); }
+  if (mapJoyLeftDpad) { addStep(stepJoyDpad); }
+  if (typeIsGuitar) { addStep(stepGuitar); }
+  if (typeIsDJ) { addStep(stepDJ); }
+  if (ghDrum) { addStep(stepGHDrum); }
+  if (queueEnabled) { addStep(stepQueue); }
+}
 void initInputs(Configuration_t *config) {
   pollRate = config->main.pollRate * 1000;
   mapJoyLeftDpad = config->main.mapLeftJoystickToDPad;
@@ -48,30 +137,34 @@ void initInputs(Configuration_t *config) {
     if (config->debounce.buttons < 5) {
       config->debounce.buttons = 5;
     }
+    initQueue(pollRate);
   }
   setupADC();
-  switch (config->main.inputType) {
+  switch (CONFIG_INPUT_TYPE(config)) {
   case WII:
     initWiiExtensions(config);
     tick_function = tickWiiExtInput;
     read_button_function = readWiiButton;
+    read_buttons_function = readPinButtons;
     dpad_bits = 0xFFFF;
     break;
   case DIRECT:
-    read_button_function = digitalReadPin;
+    read_button_function = readSampledPin;
+    read_buttons_function = readSampledButtons;
     break;
   case PS2:
     initPS2CtrlInput(config);
     read_button_function = readPS2Button;
+    read_buttons_function = readPinButtons;
     tick_function = tickPS2CtrlInput;
     dpad_bits = 0xFFFF;
     break;
   }
 
-  if (config->main.inputType != PS2 && config->main.fretLEDMode == APA102) {
+  if (CONFIG_INPUT_TYPE(config) != PS2 && config->main.fretLEDMode == APA102) {
     spi_begin(MIN(F_CPU / 2, 12000000), true, true, false);
   }
-  if (typeIsDJ || config->main.inputType == WII ||
+  if (typeIsDJ || CONFIG_INPUT_TYPE(config) == WII ||
       config->main.tiltType == MPU_6050 || config->neck.gh5Neck ||
       config->neck.gh5NeckBar) {
     // Start off by configuring things for the slower speed when using wii
@@ -82,10 +175,12 @@ void initInputs(Configuration_t *config) {
   initGuitar(config);
   joyThreshold = config->axis.joyThreshold << 8;
   triggerThreshold = config->axis.triggerThreshold;
+  hasEuphoria = false;
   for (uint8_t i = 0; i < validPins; i++) {
     Pin_t *pin = &pinData[i];
     if (pin->offset == XBOX_LEFT_STICK && typeIsDJ) {
       euphoriaPin = *pin;
+      hasEuphoria = true;
       // We don't want to treat this like a normal pin, so we move whatever is
       // at the end to this slot, so it isn't treated as a pin anymore
       if (i != validPins - 1) { pinData[i] = pinData[validPins - 1]; }
@@ -94,93 +189,43 @@ void initInputs(Configuration_t *config) {
     // If we have a pin mapped, then we don't want to be clearing it when map
     // joystick to dpad is in use
     if (pin->offset == XBOX_DPAD_UP) { dpad_bits |= (_BV(XBOX_DPAD_UP)); }
-    if (pin->offset == XBOX_DPAD_DOWN) {
-      dpad_bits |= (_BV(XBOX_DPAD_DOWN));
-      if (mergedStrum) { downStrumPin = pin; }
-    }
+    if (pin->offset == XBOX_DPAD_DOWN) { dpad_bits |= (_BV(XBOX_DPAD_DOWN)); }
     if (pin->offset == XBOX_DPAD_LEFT) { dpad_bits |= (_BV(XBOX_DPAD_LEFT)); }
     if (pin->offset == XBOX_DPAD_RIGHT) { dpad_bits |= (_BV(XBOX_DPAD_RIGHT)); }
   }
-  ghDrum = config->main.subType == XINPUT_GUITAR_HERO_DRUMS;
-}
-bool start_val = false;
-bool select_val = false;
-uint8_t queueButtons;
-bool tickInputs(Controller_t *controller) {
-  if (typeIsGuitar) { controller->r_y = 0; }
-  if (tick_function) { tick_function(controller); }
-  tickDirectInput(controller);
-  Pin_t *pin;
+  boundButtons = 0;
   for (uint8_t i = 0; i < validPins; i++) {
-    pin = &pinData[i];
-    bool val = read_button_function(pin);
-    uint8_t offset = pin->offset;
-    // If strum is merged, then we want to grab debounce data from the same
-    // button for both
-    if (mergedStrum && offset == XBOX_DPAD_UP) { pin = downStrumPin; }
-    if (micros() - pin->lastMillis > (pin->milliDeBounce * 100)) {
-      if (mapStartSelectHome) {
-        if (offset == XBOX_START) { start_val = val; }
-        if (offset == XBOX_BACK) { select_val = val; }
-      }
-      // With DJ controllers, euphoria and y are going to different pins but are
-      // the same output.
-      if (typeIsDJ && offset == XBOX_Y) {
-        val |= read_button_function(&euphoriaPin);
-      }
-      if (val != (bit_check(controller->buttons, offset))) {
-        pin->lastMillis = micros();
-        bit_write(val, controller->buttons, offset);
-        if (queueEnabled) {
-          if (offset >= 8) {
-            bit_write(val, queueButtons, (offset - 8));
-          }
-        }
-      }
-    }
-  }
-  if (mapStartSelectHome) {
-    if (start_val && select_val) {
-      bit_set(controller->buttons, XBOX_HOME);
-      bit_clear(controller->buttons, XBOX_START);
-      bit_clear(controller->buttons, XBOX_BACK);
-    } else {
-      bit_clear(controller->buttons, XBOX_HOME);
-    }
+    bit_set(boundButtons, pinData[i].offset);
   }
-  if (mapJoyLeftDpad) {
-    // Reset any bits that were not touched above (aka any unbound directions)
-    controller->buttons &= dpad_bits;
-    CHECK_JOY(l_x, XBOX_DPAD_LEFT, XBOX_DPAD_RIGHT);
-    CHECK_JOY(l_y, XBOX_DPAD_DOWN, XBOX_DPAD_UP);
+  read_raw_function = read_buttons_function;
+  if (hasEuphoria && (boundButtons & _BV(XBOX_Y))) {
+    read_raw_function = readEuphoriaButtons;
   }
-  tickGuitar(controller);
-  tickDJ(controller);
-  if (ghDrum) { controller->buttons |= _BV(XBOX_LEFT_STICK); }
-  if (queueEnabled) {
-    if (lastQueue != queueButtons) {
-      lastQueue = queueButtons;
-      queue[queueTail] = queueButtons;
-      if (queueSize < BUFFER_SIZE_QUEUE) {
-        queueSize++;
-        queueTail++;
-      }
-    }
-  }
-
-  if (micros() - lastPollBuf < pollRate) { return false; }
-  if (queueEnabled && queueSize) {
-    controller->buttons =
-        (controller->buttons & 0xFF) | (queue[queueTail - queueSize] << 8);
-    queueSize--;
+  initDebounce(config, mergedStrum);
+  CAPTURE_INIT(config);
+  ghDrum = config->main.subType == XINPUT_GUITAR_HERO_DRUMS;
+  buildInputPlan();
+}
+bool tickInputs(Controller_t *controller) {
+  TRACE_TICK();
+  RECORD_TICK();
+  for (uint8_t i = 0; i < inputPlanLength; i++) { inputPlan[i](controller); }
+  if (!schedulerReportDue(pollRate)) { return false; }
+  if (queueEnabled && tickQueue()) {
+    controller->buttons = (controller->buttons & 0xFF) | (queueOutput << 8);
   }
-  lastPollBuf = micros();
+  CAPTURE_PENDING(tickButtons);
+  RECORD(RECORD_CONTROLLER, controller, sizeof(Controller_t));
   return true;
 }
 uint8_t getVelocity(Controller_t *controller, uint8_t offset) {
   if (offset < XBOX_BTN_COUNT) {
-    if (typeIsDrum && offset > 8 && offset < 16) {
-      return drumVelocity[offset - 8];
+    if (typeIsDrum && offset >= XBOX_LB) {
+      // Only while the pad is down, so that midi gets a note off and the leds
+      // go back out
+      if (!bit_check(controller->buttons, offset)) return 0;
+      uint8_t vel = drumVelocity[offset - 8];
+      return vel ? vel : MIDI_STANDARD_VELOCITY;
     }
     return bit_check(controller->buttons, offset) ? MIDI_STANDARD_VELOCITY : 0;
   } else if (offset > XBOX_BTN_COUNT + 2) {
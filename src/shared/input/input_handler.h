@@ -14,8 +14,13 @@ void findDigitalPin(void);
 void stopSearching(void);
 void initInputs(Configuration_t* config);
 bool tickInputs(Controller_t* controller);
+// Call once the report built after tickInputs returned true has been sent
+void captureReportSent(void);
 void setSP(bool sp);
 uint8_t getVelocity(Controller_t* controller, uint8_t offset);
 extern uint8_t detectedPin;
+// Every pin found since the last find, starting with detectedPin
+extern uint8_t foundPins[];
+extern uint8_t foundCount;
 extern int16_t analogueData[XBOX_AXIS_COUNT];
 extern Pin_t pinData[XBOX_BTN_COUNT];
\ No newline at end of file
@@ -2,8 +2,13 @@
 #include "controller/controller.h"
 #include "eeprom/eeprom.h"
 #include "guitar.h"
+#include "input/calibrate.h"
+#include "input/curve.h"
+#include "input/drums.h"
+#include "input/filter.h"
 #include "output/descriptors.h"
 #include "pins/pins.h"
+#include "stats/trace.h"
 #include "util/util.h"
 #include <stdlib.h>
 int validPins = 0;
@@ -11,16 +16,109 @@ uint8_t detectedPin = 0xff;
 bool lookingForDigital = false;
 bool lookingForAnalog = false;
 int lastAnalogValue[NUM_ANALOG_INPUTS];
-bool lastDigitalValue[NUM_DIGITAL_PINS];
+// Pin detection watches every free pin at once. Digital pins are pulled up and
+// read back a whole port at a time, and every pin that changes is recorded
+// until the configurator collects them with COMMAND_GET_FOUND, so more than one
+// button can be found from a single request.
+#define DETECT_MAX_FOUND 16
+// The mega has the most, with 11
+#define DETECT_MAX_PORTS 12
+uint8_t detectPortCount;
+uint8_t detectPorts[DETECT_MAX_PORTS];
+port_t detectMasks[DETECT_MAX_PORTS];
+port_t detectBaseline[DETECT_MAX_PORTS];
+port_t detectSeen[DETECT_MAX_PORTS];
+uint16_t detectAnalogSeen;
+uint8_t foundPins[DETECT_MAX_FOUND];
+uint8_t foundCount;
 AnalogInfo_t joyData[NUM_ANALOG_INPUTS];
 int16_t analogueData[XBOX_AXIS_COUNT];
 bool usingI2C;
 bool usingSPI;
 bool misoAvailable;
 uint8_t spPin;
-uint8_t tiltType;
 uint8_t drumVelocity[8];
+#ifdef BAKED_CONFIG
+static const uint8_t tiltType = BAKED_TILT_TYPE;
+static const AxisScale_t scales[6] = {BAKED_AXIS_SCALES};
+#else
+uint8_t tiltType;
 AxisScale_t scales[6];
+#endif
+// Direct buttons are sampled a whole port at a time, and then moved into
+// place in the button word with a mask and a shift. Pins that are wired in the
+// same order as the buttons they are bound to share a mask, so a neatly wired
+// controller only needs a few of these.
+typedef struct {
+  uint8_t port;
+  int8_t shift;
+  port_t mask;
+} PortGroup_t;
+uint8_t samplePortCount;
+uint8_t samplePorts[XBOX_BTN_COUNT];
+port_t sampleInvert[XBOX_BTN_COUNT];
+uint8_t sampleGroupCount;
+PortGroup_t sampleGroups[XBOX_BTN_COUNT];
+port_t sampleValues[XBOX_BTN_COUNT];
+uint16_t sampledButtons;
+// Drum pins are analog, so they can't be sampled with the rest
+uint8_t sampleAnalogCount;
+Pin_t *sampleAnalogPins[XBOX_BTN_COUNT];
+void addSampledPin(Pin_t *pin) {
+  uint8_t port = pinPort(pin);
+  uint8_t idx = 0;
+  while (idx < samplePortCount && samplePorts[idx] != port) { idx++; }
+  if (idx == samplePortCount) {
+    samplePorts[samplePortCount++] = port;
+    sampleInvert[idx] = 0;
+  }
+  uint8_t bit = pinBit(pin);
+  port_t mask = (port_t)1 << bit;
+  // Pull ups read low when pressed
+  if (!pin->eq) { sampleInvert[idx] |= mask; }
+  int8_t shift = pin->offset - bit;
+  for (uint8_t i = 0; i < sampleGroupCount; i++) {
+    if (sampleGroups[i].port == idx && sampleGroups[i].shift == shift) {
+      sampleGroups[i].mask |= mask;
+      return;
+    }
+  }
+  sampleGroups[sampleGroupCount++] = (PortGroup_t){idx, shift, mask};
+}
+// Moves every bound pin in the sampled ports into place in the button word
+uint16_t portsToButtons(const port_t *values) {
+  uint16_t buttons = 0;
+  for (uint8_t i = 0; i < sampleGroupCount; i++) {
+    PortGroup_t *group = &sampleGroups[i];
+    port_t val = (values[group->port] ^ sampleInvert[group->port]) & group->mask;
+    if (group->shift >= 0) {
+      buttons |= (uint16_t)val << group->shift;
+    } else {
+      buttons |= val >> -group->shift;
+    }
+  }
+  return buttons;
+}
+void samplePins(void) {
+  // Read every port before doing anything else, so that all the buttons are
+  // sampled as close together as possible
+  for (uint8_t i = 0; i < samplePortCount; i++) {
+    sampleValues[i] = readPort(samplePorts[i]);
+  }
+  sampledButtons = portsToButtons(sampleValues);
+}
+uint16_t readSampledButtons(void) {
+  uint16_t buttons = sampledButtons;
+  for (uint8_t i = 0; i < sampleAnalogCount; i++) {
+    Pin_t *pin = sampleAnalogPins[i];
+    if (drumHeld(pin)) { bit_set(buttons, pin->offset); }
+  }
+  return buttons;
+}
+bool readSampledPin(Pin_t *pin) {
+  if (pin->analogOffset != INVALID_PIN) { return drumHeld(pin); }
+  return bit_check(sampledButtons, pin->offset);
+}
 void reinitDirectInput(void) {
   if (spPin != INVALID_PIN) { pinMode(spPin, OUTPUT); }
   for (int i = 0; i < validPins; i++) {
@@ -30,21 +128,26 @@ void reinitDirectInput(void) {
   }
 }
 void initDirectInput(Configuration_t *config) {
-  usingI2C =
-      (config->main.tiltType == MPU_6050 || config->main.inputType == WII || typeIsDJ);
+  usingI2C = (config->main.tiltType == MPU_6050 ||
+              CONFIG_INPUT_TYPE(config) == WII || typeIsDJ);
   usingSPI =
-      (config->main.fretLEDMode == APA102) || config->main.inputType == PS2;
-  misoAvailable = config->main.inputType != PS2;
+      (config->main.fretLEDMode == APA102) || CONFIG_INPUT_TYPE(config) == PS2;
+  misoAvailable = CONFIG_INPUT_TYPE(config) != PS2;
   spPin = config->pinsSP;
+#ifndef BAKED_CONFIG
   tiltType = config->main.tiltType;
-  uint8_t *pins = (uint8_t *)&config->pins;
   memcpy(scales, &config->axisScale, sizeof(scales));
+#endif
+  uint8_t *pins = (uint8_t *)&config->pins;
+  initFilters(config);
+  initCurves(config);
+  CALIBRATE_INIT(config, scales);
   validPins = 0;
   setUpValidPins(config);
   if (config->pinsSP != INVALID_PIN) { pinMode(config->pinsSP, OUTPUT); }
   for (size_t i = 0; i < XBOX_BTN_COUNT; i++) {
     Pin_t *pin = &pinData[validPins];
-    if (config->main.inputType == DIRECT) {
+    if (CONFIG_INPUT_TYPE(config) == DIRECT) {
       if (pins[i] != INVALID_PIN) {
         bool is_fret = (i >= XBOX_A || i == XBOX_LB || i == XBOX_RB);
         validPins++;
@@ -55,7 +158,7 @@ void initDirectInput(Configuration_t *config) {
           // using isfret
           // ADC is 10 bit, thereshold is specified as an 8 bit value, so shift
           // it
-          setUpAnalogDigitalPin(pin, pins[i], config->axis.drumThreshold << 3);
+          setUpAnalogDigitalPin(pin, pins[i], config->axis.drumThreshold << 2);
         } else {
           pinMode(pins[i], pin->eq ? INPUT : INPUT_PULLUP);
         }
@@ -64,9 +167,19 @@ void initDirectInput(Configuration_t *config) {
       validPins++;
       setUpDigital(pin, config, 0, i, false, false);
     }
-      // Fill data for debounce
-    if (typeIsGuitar && (pin->offset == XBOX_DPAD_DOWN || pin->offset == XBOX_DPAD_UP)) {
-      pin->milliDeBounce = config->debounce.strum;
+  }
+  initDrums();
+  samplePortCount = 0;
+  sampleGroupCount = 0;
+  sampleAnalogCount = 0;
+  sampledButtons = 0;
+  if (CONFIG_INPUT_TYPE(config) == DIRECT) {
+    for (uint8_t i = 0; i < validPins; i++) {
+      if (pinData[i].analogOffset == INVALID_PIN) {
+        addSampledPin(&pinData[i]);
+      } else {
+        sampleAnalogPins[sampleAnalogCount++] = &pinData[i];
+      }
     }
   }
 }
@@ -100,16 +213,37 @@ bool shouldSkipPin(uint8_t i) {
   return false;
 }
 
+void addFoundPin(uint8_t pin) {
+  if (foundCount == DETECT_MAX_FOUND) return;
+  if (!foundCount) { detectedPin = pin; }
+  foundPins[foundCount++] = pin;
+}
+
 void findDigitalPin(void) {
   if (lookingForDigital) return;
   detectedPin = 0xff;
+  foundCount = 0;
   stopReading();
-  for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
-    if (!shouldSkipPin(i)) {
-      pinMode(i, INPUT_PULLUP);
-      _delay_us(100);
-      lastDigitalValue[i] = digitalRead(i);
+  detectPortCount = 0;
+  for (uint8_t i = 0; i < NUM_DIGITAL_PINS; i++) {
+    if (shouldSkipPin(i)) continue;
+    uint8_t port = digitalPinPort(i);
+    uint8_t idx = 0;
+    while (idx < detectPortCount && detectPorts[idx] != port) { idx++; }
+    if (idx == detectPortCount) {
+      detectPorts[detectPortCount++] = port;
+      detectMasks[idx] = 0;
     }
+    detectMasks[idx] |= digitalPinMask(i);
+  }
+  for (uint8_t i = 0; i < detectPortCount; i++) {
+    pullUpPort(detectPorts[i], detectMasks[i]);
+    detectSeen[i] = 0;
+  }
+  // Wait for the pull ups once, instead of once per pin
+  _delay_us(100);
+  for (uint8_t i = 0; i < detectPortCount; i++) {
+    detectBaseline[i] = readPort(detectPorts[i]);
   }
   lookingForDigital = true;
 }
@@ -117,79 +251,97 @@ void findDigitalPin(void) {
 void findAnalogPin(void) {
   if (lookingForAnalog) return;
   detectedPin = 0xff;
+  foundCount = 0;
+  detectAnalogSeen = 0;
   stopReading();
   for (int i = 0; i < NUM_ANALOG_INPUTS; i++) {
     pinMode(PIN_A0 + i, INPUT_PULLUP_ANALOG);
-    _delay_us(100);
+  }
+  _delay_us(100);
+  for (int i = 0; i < NUM_ANALOG_INPUTS; i++) {
     lastAnalogValue[i] = analogRead(i);
   }
   lookingForAnalog = true;
 }
 
 void stopSearching(void) {
-  if (lookingForDigital) {
-    for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
-      lastDigitalValue[i] = digitalRead(i);
-    }
-    reinitDirectInput();
-  }
+  if (lookingForDigital || lookingForAnalog) { reinitDirectInput(); }
   lookingForDigital = lookingForAnalog = false;
 }
 
-void setSP(bool sp) {
-  if (spPin != INVALID_PIN) { digitalWrite(spPin, sp); }
-}
-
-void tickDirectInput(Controller_t *controller) {
+void tickDetection(void) {
   if (lookingForAnalog) {
-    for (int i = 0; i < NUM_ANALOG_INPUTS; i++) {
+    for (uint8_t i = 0; i < NUM_ANALOG_INPUTS; i++) {
+      if (bit_check(detectAnalogSeen, i)) continue;
       if (abs(analogRead(i) - lastAnalogValue[i]) > 30) {
-        detectedPin = i + PIN_A0;
-        lookingForAnalog = false;
-        return;
+        bit_set(detectAnalogSeen, i);
+        addFoundPin(i + PIN_A0);
       }
     }
     return;
   }
-  if (lookingForDigital) {
-    for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
-      if (!shouldSkipPin(i)) {
-        if (digitalRead(i) != lastDigitalValue[i]) {
-          stopSearching();
-          detectedPin = i;
-          lookingForDigital = false;
-          return;
-        }
+  for (uint8_t i = 0; i < detectPortCount; i++) {
+    port_t changed = (readPort(detectPorts[i]) ^ detectBaseline[i]) &
+                     detectMasks[i] & ~detectSeen[i];
+    if (!changed) continue;
+    detectSeen[i] |= changed;
+    for (uint8_t pin = 0; pin < NUM_DIGITAL_PINS; pin++) {
+      if (digitalPinPort(pin) == detectPorts[i] &&
+          (digitalPinMask(pin) & changed)) {
+        addFoundPin(pin);
       }
     }
+  }
+}
+
+void setSP(bool sp) {
+  if (spPin != INVALID_PIN) { digitalWrite(spPin, sp); }
+}
+
+void tickDirectInput(Controller_t *controller) {
+  if (lookingForAnalog || lookingForDigital) {
+    tickDetection();
     return;
   }
+  samplePins();
+  TRACE_BEGIN(TRACE_ANALOG);
   tickAnalog();
+  TRACE_END(TRACE_ANALOG);
   AnalogInfo_t info;
   ControllerCombined_t *combinedController = (ControllerCombined_t *)controller;
   AxisScale_t scale;
+#ifndef ADC_SCAN
+  uint32_t now = micros();
+#endif
   for (int8_t i = 0; i < validAnalog; i++) {
     info = joyData[i];
     if (info.hasDigital) {
-      drumVelocity[info.offset - 8] = info.value;
+      // With ADC_SCAN the platform feeds the drums every sample itself
+#ifndef ADC_SCAN
+      drumSampled(i, info.value, now);
+#endif
     } else {
       if (i == XBOX_TILT && typeIsGuitar && tiltType == DIGITAL) { continue; }
       analogueData[info.offset] = info.value;
+      // Triggers center at -32767, sticks center at 0. Whammy works similar to
+      // a trigger, so we also count it here.
+      bool trigger =
+          info.offset < 2 || (typeIsGuitar && info.offset == XBOX_WHAMMY);
+      int32_t val = filterAxis(info.offset, info.value);
+      CALIBRATE_AXIS(info.offset, val, &scales[info.offset], trigger);
       scale = scales[info.offset];
-      int32_t val = info.value;
       val -= scale.offset;
       val *= scale.multiplier;
       val /= 1024;
       val += INT16_MIN;
       if (val > INT16_MAX) val = INT16_MAX;
       if (val < INT16_MIN) val = INT16_MIN;
-      // Triggers center at -32767, sticks center at 0. Whammy works similar to
-      // a trigger, so we also count it here.
-      if (info.offset < 2 || (typeIsGuitar && info.offset == XBOX_WHAMMY)) {
+      if (trigger) {
         if (val < scale.deadzone) { val = INT16_MIN; }
       } else if (val < scale.deadzone && val > -scale.deadzone) {
         val = 0;
       }
+      val = curveAxis(info.offset, val);
       if (info.offset >= 2) {
         combinedController->sticks[info.offset - 2] = val;
       } else {
@@ -197,4 +349,5 @@ void tickDirectInput(Controller_t *controller) {
       }
     }
   }
+  tickDrums(sampleAnalogPins, sampleAnalogCount);
 }
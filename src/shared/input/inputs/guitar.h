@@ -4,6 +4,8 @@
 #include "eeprom/eeprom.h"
 #include "guitar.h"
 #include "i2c/i2c.h"
+#include "input/curve.h"
+#include "motion_plus.h"
 #include "mpu6050/inv_mpu.h"
 #include "mpu6050/inv_mpu_dmp_motion_driver.h"
 #include "mpu6050/mpu_math.h"
@@ -34,16 +36,7 @@ bool tiltInverted;
 AxisScale_t scale;
 Pin_t wtPin;
 uint8_t lastTap;
-void tickMPUTilt(Controller_t *controller) {
-  static short sensors;
-  static unsigned char fifoCount;
-  dmp_read_fifo(NULL, NULL, q._l, NULL, &sensors, &fifoCount);
-  q._f.w = q._l[0] >> 23;
-  q._f.x = q._l[1] >> 23;
-  q._f.y = q._l[2] >> 23;
-  q._f.z = q._l[3] >> 23;
-
-  quaternionToEuler(&q._f, &mpuTilt, mpuOrientation);
+static void setGyroTilt(Controller_t *controller) {
   mpuTilt = tiltInverted ? -mpuTilt : mpuTilt;
   analogueData[XBOX_TILT] = mpuTilt;
   int32_t val = mpuTilt;
@@ -54,7 +47,25 @@ void tickMPUTilt(Controller_t *controller) {
   if (val > INT16_MAX) val = INT16_MAX;
   if (val < INT16_MIN) val = INT16_MIN;
   // if (val < scale.deadzone) { val = INT16_MIN; }
-  controller->r_y = val;
+  controller->r_y = curveAxis(XBOX_TILT, val);
+}
+void tickMPUTilt(Controller_t *controller) {
+  static short sensors;
+  static unsigned char fifoCount;
+  dmp_read_fifo(NULL, NULL, q._l, NULL, &sensors, &fifoCount);
+  q._f.w = q._l[0] >> 23;
+  q._f.x = q._l[1] >> 23;
+  q._f.y = q._l[2] >> 23;
+  q._f.z = q._l[3] >> 23;
+
+  quaternionToEuler(&q._f, &mpuTilt, mpuOrientation);
+  setGyroTilt(controller);
+}
+// The MotionPlus is read along with the extension, this just picks up the
+// angle that was worked out from the last gyro frame
+void tickMotionPlusTilt(Controller_t *controller) {
+  mpuTilt = motionPlusTilt;
+  setGyroTilt(controller);
 }
 void tickDigitalTilt(Controller_t *controller) {
   controller->r_y = digitalReadPin(&tiltPin) ? 32767 : 0;
@@ -85,6 +96,8 @@ void initGuitar(Configuration_t *config) {
     setUpDigital(&tiltPin, config, config->pins.r_y.pin, 0, false, false);
     pinMode(tiltPin.pin, INPUT_PULLUP);
     tick = tickDigitalTilt;
+  } else if (config->main.tiltType == MOTION_PLUS) {
+    tick = tickMotionPlusTilt;
   }
 
   gh5Neck = config->neck.gh5Neck || config->neck.gh5NeckBar;
@@ -0,0 +1,110 @@
+#pragma once
+#include "config/defines.h"
+#include "controller/controller.h"
+#include "eeprom/eeprom.h"
+#include "util/util.h"
+#include <stdbool.h>
+#include <stdint.h>
+// The Wii MotionPlus sits between the controller and an extension. Until it is
+// activated it hides at MOTION_PLUS_ADDR and passes the extension through as
+// is, and once it is activated it takes over I2C_ADDR, and every read returns
+// either a gyro frame or an extension frame, alternating between the two if
+// something is plugged into it. Extension frames lose a few bits to make room
+// for telling the two apart, so motionPlusUnpack puts them back into the layout
+// the normal decoders expect, with the missing low bits left as 0.
+//
+// The gyro only gives rates, so the tilt is the rate of the configured axis
+// integrated over time. The rest position is learned while the axis is still,
+// and the angle slowly leaks back towards 0, so that the drift from integrating
+// doesn't add up over a session.
+#define MOTION_PLUS_ADDR 0x53
+#define MOTION_PLUS_STANDALONE 0x04
+#define MOTION_PLUS_NUNCHUK 0x05
+#define MOTION_PLUS_CLASSIC 0x07
+// How long it takes to show up at I2C_ADDR (or go back) after being switched
+#define MOTION_PLUS_SWITCH_MS 20
+// Slow mode is about 20 counts per deg/s, and fast mode is 2000 / 440 times
+// that. These turn counts * us into 1/256ths of the 1/65536 turn units that
+// quaternionToEuler uses.
+#define MOTION_PLUS_SLOW_DIV 429
+#define MOTION_PLUS_FAST_DIV 94
+// Frames further apart than this are from before a gap in reading, not a rate
+// that held for that long
+#define MOTION_PLUS_MAX_DT_US 20000
+// Rates within this many counts of the rest position count as still, and the
+// rest position follows them with a 1 / (1 << MOTION_PLUS_REST_SHIFT) EMA
+#define MOTION_PLUS_REST_BAND 64
+#define MOTION_PLUS_REST_SHIFT 6
+// The angle leaks back to 0 with a time constant of 1 << 22 us (about 4s)
+#define MOTION_PLUS_LEAK_SHIFT 11
+// Same range and gain that quaternionToEuler gives the mpu 6050 tilt
+#define MOTION_PLUS_TILT_GAIN 5
+#define MOTION_PLUS_MAX_ANGLE ((int32_t)(INT16_MAX / MOTION_PLUS_TILT_GAIN) << 8)
+bool motionPlusWanted;
+uint8_t motionPlusAxis;
+// Learned rest position, with 4 fractional bits
+int32_t motionPlusRest;
+int32_t motionPlusAngle;
+uint32_t motionPlusLastFrame;
+bool motionPlusPrimed;
+int16_t motionPlusTilt;
+void initMotionPlus(Configuration_t *config) {
+  motionPlusWanted = config->main.tiltType == MOTION_PLUS;
+  motionPlusAxis = config->axis.mpu6050Orientation;
+  motionPlusAngle = 0;
+  motionPlusPrimed = false;
+  motionPlusTilt = 0;
+}
+// Handles a gyro frame. X is pitch, Y is roll and Z is yaw, going by how the
+// MotionPlus names them.
+void motionPlusGyro(const uint8_t *data, uint32_t now) {
+  uint8_t idx = motionPlusAxis == Z ? 0 : motionPlusAxis == Y ? 1 : 2;
+  int32_t raw = data[idx] | (data[idx + 3] & 0xFC) << 6;
+  // Yaw and pitch have their slow bits in byte 3, and roll has its in byte 4
+  bool slow = motionPlusAxis == Y   ? bit_check(data[4], 1)
+              : motionPlusAxis == Z ? bit_check(data[3], 1)
+                                    : bit_check(data[3], 0);
+  if (!motionPlusPrimed) {
+    motionPlusRest = raw << 4;
+    motionPlusLastFrame = now;
+    motionPlusPrimed = true;
+    return;
+  }
+  uint32_t dt = now - motionPlusLastFrame;
+  motionPlusLastFrame = now;
+  if (dt > MOTION_PLUS_MAX_DT_US) return;
+  int32_t rate = raw - (motionPlusRest >> 4);
+  if (rate < MOTION_PLUS_REST_BAND && rate > -MOTION_PLUS_REST_BAND) {
+    motionPlusRest += ((raw << 4) - motionPlusRest) >> MOTION_PLUS_REST_SHIFT;
+  }
+  motionPlusAngle += rate * (int32_t)dt /
+                     (slow ? MOTION_PLUS_SLOW_DIV : MOTION_PLUS_FAST_DIV);
+  motionPlusAngle -=
+      ((motionPlusAngle >> MOTION_PLUS_LEAK_SHIFT) * (int32_t)dt) >>
+      MOTION_PLUS_LEAK_SHIFT;
+  if (motionPlusAngle > MOTION_PLUS_MAX_ANGLE) {
+    motionPlusAngle = MOTION_PLUS_MAX_ANGLE;
+  }
+  if (motionPlusAngle < -MOTION_PLUS_MAX_ANGLE) {
+    motionPlusAngle = -MOTION_PLUS_MAX_ANGLE;
+  }
+  motionPlusTilt = (motionPlusAngle >> 8) * MOTION_PLUS_TILT_GAIN;
+}
+// Turns a passthrough extension frame back into a normal one, in place
+void motionPlusUnpack(uint8_t *data, uint8_t mode) {
+  if (mode == MOTION_PLUS_NUNCHUK) {
+    // Byte 4 loses the bottom bit of the z accel to the extension bit, and
+    // byte 5 loses the bottom bit of every accel axis
+    uint8_t b5 = data[5];
+    data[4] = (data[4] & 0xFE) | b5 >> 7;
+    data[5] = ((b5 << 1) & 0x80) | (b5 & 0x20) | ((b5 >> 1) & 0x08) |
+              ((b5 >> 2) & 0x03);
+  } else {
+    // The bottom bit of both left stick axes is taken by up and left on the
+    // dpad, and the bit that is always set in byte 4 is the extension bit
+    data[5] = (data[5] & 0xFC) | (data[1] & 1) << 1 | (data[0] & 1);
+    data[0] &= 0xFE;
+    data[1] &= 0xFE;
+    data[4] |= 0x01;
+  }
+}
@@ -5,6 +5,7 @@
 #include "pins/pins.h"
 #include "pins_arduino.h"
 #include "spi/spi.h"
+#include "stats/record.h"
 #include "timer/timer.h"
 #include "util/util.h"
 #include <math.h>
@@ -340,6 +341,8 @@ bool read(uint8_t port, Controller_t *controller) {
   uint8_t *in;
   in = autoShiftData(port, commandPollInput, sizeof(commandPollInput));
   if (in != NULL) {
+    // Leave out the padding byte that is clocked in while sending the port
+    RECORD(RECORD_PS2, in + 1, (in[1] & 0x0F) * 2 + 2);
 
     if (isConfigReply(in)) {
       // We're stuck in config mode, try to get out
@@ -4,7 +4,10 @@
 #include "eeprom/eeprom.h"
 #include "fxpt_math/fxpt_math.h"
 #include "i2c/i2c.h"
+#include "motion_plus.h"
+#include "wii_layouts.h"
 #include "pins/pins.h"
+#include "stats/record.h"
 #include "timer/timer.h"
 #include "util/util.h"
 #include <stdbool.h>
@@ -18,22 +21,23 @@
 #define LOWRES_MODE 0x03
 #define HIGHRES_MODE 0x03
 void tickWiiExtInput(Controller_t *controller);
-uint8_t wiiButtonBindings[XBOX_BTN_COUNT] = {[XBOX_DPAD_UP] = WII_DPAD_UP,
-                                             [XBOX_DPAD_DOWN] = WII_DPAD_DOWN,
-                                             [XBOX_DPAD_LEFT] = WII_DPAD_LEFT,
-                                             [XBOX_DPAD_RIGHT] = WII_DPAD_RIGHT,
-                                             [XBOX_START] = WII_PLUS,
-                                             [XBOX_BACK] = WII_MINUS,
-                                             [XBOX_LEFT_STICK] = INVALID_PIN,
-                                             [XBOX_RIGHT_STICK] = INVALID_PIN,
-                                             [XBOX_LB] = WII_ZL,
-                                             [XBOX_RB] = WII_ZR,
-                                             [XBOX_HOME] = WII_HOME,
-                                             [XBOX_UNUSED] = INVALID_PIN,
-                                             [XBOX_A] = WII_A,
-                                             [XBOX_B] = WII_B,
-                                             [XBOX_X] = WII_Y,
-                                             [XBOX_Y] = WII_X};
+const uint8_t wiiButtonBindings[XBOX_BTN_COUNT] = {
+    [XBOX_DPAD_UP] = WII_DPAD_UP,
+    [XBOX_DPAD_DOWN] = WII_DPAD_DOWN,
+    [XBOX_DPAD_LEFT] = WII_DPAD_LEFT,
+    [XBOX_DPAD_RIGHT] = WII_DPAD_RIGHT,
+    [XBOX_START] = WII_PLUS,
+    [XBOX_BACK] = WII_MINUS,
+    [XBOX_LEFT_STICK] = INVALID_PIN,
+    [XBOX_RIGHT_STICK] = INVALID_PIN,
+    [XBOX_LB] = WII_ZL,
+    [XBOX_RB] = WII_ZR,
+    [XBOX_HOME] = WII_HOME,
+    [XBOX_UNUSED] = INVALID_PIN,
+    [XBOX_A] = WII_A,
+    [XBOX_B] = WII_B,
+    [XBOX_X] = WII_Y,
+    [XBOX_Y] = WII_X};
 uint16_t wiiExtensionID = WII_NO_EXTENSION;
 uint16_t buttons;
 uint8_t bytes = 6;
@@ -67,10 +71,7 @@ uint16_t readExtID(void) {
   return data[0] << 8 | data[5];
 }
 void readDrumExt(Controller_t *controller, uint8_t *data) {
-  controller->l_x = (data[0] - 0x20) << 10;
-  controller->l_y = (data[1] - 0x20) << 10;
-  // Mask out unused bits
-  buttons = ~(data[4] | (data[5] << 8)) & 0xfeff;
+  WII_DECODE(WII_DRUM_LAYOUT);
   if (fullDeviceType >= MIDI_GAMEPAD && bit_check(data[3], 1)) {
     uint8_t vel = (7 - (data[3] >> 5)) << 5;
     uint8_t which = (data[2] & 0b01111100) >> 1;
@@ -116,8 +117,7 @@ uint8_t wiiwttapbindings[] = {[0x2] = (_BV(XBOX_A)) >> 8,
                               [0xf] = (_BV(XBOX_LB)) >> 8};
 
 void readGuitarExt(Controller_t *controller, uint8_t *data) {
-  controller->l_x = ((data[0] & 0x3f) - 32) << 10;
-  controller->l_y = ((data[1] & 0x3f) - 32) << 10;
+  WII_DECODE(WII_GUITAR_LAYOUT);
   // Whammy is weird, it ranges from 0 - 12. multiply by 2.5 to get from 0 - 36,
   // clamp, and then shift to 0 - 65535
   controller->r_x = ((data[3] & 0x1f) - 14);
@@ -127,64 +127,42 @@ void readGuitarExt(Controller_t *controller, uint8_t *data) {
   controller->r_x -= 16;
   controller->r_x <<= 11;
 
-  buttons = ~(data[4] | data[5] << 8);
   if (guitarTapBar) {
-    uint8_t tap = ((data[2] & 0x1f) - 14);
-    buttons |= wiiwttapbindings[tap >> 1] << 8;
+    // Anything below 14 wraps around, past the end of the table
+    uint8_t tap = ((data[2] & 0x1f) - 14) >> 1;
+    if (tap < sizeof(wiiwttapbindings)) {
+      buttons |= wiiwttapbindings[tap] << 8;
+    }
   }
 }
 void readClassicExtHighRes(Controller_t *controller, uint8_t *data) {
-  controller->l_x = (data[0] - 0x80) << 8;
-  controller->l_y = (data[2] - 0x80) << 8;
-  controller->r_x = (data[1] - 0x80) << 8;
-  controller->r_y = (data[3] - 0x80) << 8;
-  controller->lt = data[4];
-  controller->rt = data[5];
-  buttons = ~(data[6] | (data[7] << 8));
+  WII_DECODE(WII_CLASSIC_HIGH_RES_LAYOUT);
 }
 void readClassicExt(Controller_t *controller, uint8_t *data) {
-  controller->l_x = (data[0] & 0x3f) - 32;
-  controller->l_y = (data[1] & 0x3f) - 32;
-  controller->r_x =
-      ((((data[0] & 0xc0) >> 3) | ((data[1] & 0xc0) >> 5) | (data[2] >> 7)) -
-       16)
-      << 10;
-  controller->r_y = ((data[2] & 0x1f) - 16) << 10;
-  controller->lt = ((data[3] >> 5) | ((data[2] & 0x60) >> 2));
-  controller->rt = data[3] & 0x1f;
-  buttons = ~(data[4] | data[5] << 8);
+  WII_DECODE(WII_CLASSIC_LAYOUT);
 }
 void readNunchukExt(Controller_t *controller, uint8_t *data) {
-  controller->l_x = (data[0] - 0x80) << 8;
-  controller->l_y = (data[1] - 0x80) << 8;
+  WII_DECODE(WII_NUNCHUK_LAYOUT);
   if (mapNunchukAccelToRightJoy) {
     uint16_t accX = ((data[2] << 2) | ((data[5] & 0xC0) >> 6)) - 511;
     uint16_t accY = ((data[3] << 2) | ((data[5] & 0x30) >> 4)) - 511;
     uint16_t accZ = ((data[4] << 2) | ((data[5] & 0xC) >> 2)) - 511;
-    controller->r_x = fxpt_atan2(accX, accZ);
-    controller->r_y = fxpt_atan2(accY, accZ);
+    controller->r_x = fxpt_atan2_fast(accX, accZ);
+    controller->r_y = fxpt_atan2_fast(accY, accZ);
   }
-  buttons = 0;
-  bit_write(!bit_check(data[5], 0), buttons, wiiButtonBindings[XBOX_A]);
-  bit_write(!bit_check(data[5], 1), buttons, wiiButtonBindings[XBOX_B]);
 }
 void readDJExt(Controller_t *controller, uint8_t *data) {
+  WII_DECODE(WII_DJ_LAYOUT);
   uint8_t rtt =
       (data[2] & 0x80) >> 7 | (data[1] & 0xC0) >> 5 | (data[0] & 0xC0) >> 3;
 
   uint8_t ltt =
       (data[4] & 1) ? 32 + (0x1F - (data[3] & 0x1F)) : 32 - (data[3] & 0x1F);
   rtt = (data[2] & 1) ? 32 + (0x1F - rtt) : 32 - rtt;
-  uint8_t effect_dial = (data[3] & 0xE0) >> 5 | (data[2] & 0x60) >> 2;
-  uint8_t crossfade = (data[2] & 0x1E) >> 1;
 
   controller->l_x = ltt;
   controller->l_y = rtt;
-  controller->r_x = effect_dial;
-  controller->r_y = crossfade;
-  
-  buttons = ~(data[4] << 8 | data[5]) & 0x63CD;
-  
+
   int8_t l_x = ((data[0] & 0x3F) - 0x20);
   int8_t l_y = ((data[1] & 0x3F) - 0x20);
   if (l_x < -32) { bit_set(controller->buttons, XBOX_DPAD_LEFT); }
@@ -193,27 +171,166 @@ void readDJExt(Controller_t *controller, uint8_t *data) {
   if (l_y > 32) { bit_set(controller->buttons, XBOX_DPAD_DOWN); }
 }
 void readUDrawExt(Controller_t *controller, uint8_t *data) {
-  controller->l_x = ((data[2] & 0x0f) << 8) | data[0];
-  controller->l_y = ((data[2] & 0xf0) << 4) | data[1];
-  controller->rt = data[3];
-  buttons = 0;
-  bit_write(bit_check(data[5], 0), buttons, wiiButtonBindings[XBOX_A]);
-  bit_write(bit_check(data[5], 1), buttons, wiiButtonBindings[XBOX_B]);
-  bit_write(!bit_check(data[5], 2), buttons, wiiButtonBindings[XBOX_X]);
+  WII_DECODE(WII_UDRAW_LAYOUT);
 }
 void readDrawsomeExt(Controller_t *controller, uint8_t *data) {
-  controller->l_x = data[0] | data[1] << 8;
-  controller->l_y = data[2] | data[3] << 8;
-  controller->rt = data[4] | (data[5] & 0x0f) << 8;
+  WII_DECODE(WII_DRAWSOME_LAYOUT);
   // controller->status = data[5]>>4;
 }
 void readTataconExt(Controller_t *controller, uint8_t *data) {
   // We can just skip all the other bytes except for the buttons
-  buttons = ~(data[0]);
+  WII_DECODE(WII_TATACON_LAYOUT);
+}
+// Reading an extension means setting its pointer, waiting for it to get the
+// data ready, and then reading it back. Instead of sitting in a busy wait for
+// all of that, each step is started and then left to run while the rest of the
+// tick happens, and tickWiiExtInput moves on to the next step once the last one
+// is done. As soon as a read has been collected the pointer is set for the next
+// one, so the wait has usually passed by the time the next tick comes around.
+enum WiiReadState {
+  WII_READ_IDLE,
+  WII_READ_POINTER,
+  WII_READ_WAIT,
+  WII_READ_DATA
+};
+// Writing the pointer is about 20 bits, which is 200us on the slower 5tar bus
+#define WII_POINTER_WRITE_US 200
+// Long enough for either step, even with the slower 5tar bus speed
+#define WII_READ_TIMEOUT_US 2000
+uint8_t wiiReadState = WII_READ_IDLE;
+uint32_t wiiReadStarted;
+// The GH5 neck, DJ Hero turntables and MPU 6050 are read with blocking
+// transfers later on in the tick, which would trample over one that is still
+// going (on the pico they even reset the controller), so when they are on the
+// bus transfers are finished before returning. The wait for the data to be
+// ready still doesn't need anything on the bus, so it is kept.
+bool wiiSharesBus;
+static bool startWiiPointer(void) {
+  wiiReadStarted = micros();
+  wiiReadState = WII_READ_POINTER;
+  return twi_startWrite(I2C_ADDR, &dataReadIndex, 1);
+}
+// Hot plugging. An extension can be pulled out or plugged in at any point, and
+// going through all of initWiiExt on every tick while nothing is plugged in
+// takes up most of the loop. Instead the bus is only checked every so often,
+// backing off further each time nothing answers, and checking is just seeing
+// if anything acks the extension address, which is far cheaper than reading
+// an id. Only once something answers is it set up again.
+#define WII_BACKOFF_MIN_MS 4
+#define WII_BACKOFF_MAX_MS 512
+uint16_t wiiBackoff = 0;
+uint32_t wiiRetryAt = 0;
+// Classic controllers are put into high res mode if they take it, which takes
+// a few tries and then reading the id back. Whether an id took it last time is
+// kept, so a replug (or a glitch on the bus) doesn't have to find out again.
+#define WII_RES_CACHE_SIZE 4
+enum WiiResMode { WII_RES_UNKNOWN, WII_RES_HIGH, WII_RES_LOW };
+typedef struct {
+  uint16_t id;
+  uint8_t mode;
+} WiiResCache_t;
+WiiResCache_t wiiResCache[WII_RES_CACHE_SIZE];
+uint8_t wiiResCacheNext = 0;
+static WiiResCache_t *findWiiRes(uint16_t id) {
+  for (uint8_t i = 0; i < WII_RES_CACHE_SIZE; i++) {
+    if (wiiResCache[i].mode != WII_RES_UNKNOWN && wiiResCache[i].id == id) {
+      return &wiiResCache[i];
+    }
+  }
+  WiiResCache_t *entry = &wiiResCache[wiiResCacheNext];
+  wiiResCacheNext = (wiiResCacheNext + 1) % WII_RES_CACHE_SIZE;
+  entry->id = id;
+  entry->mode = WII_RES_UNKNOWN;
+  return entry;
+}
+// Checks the id after the first tries writes, and then after every write
+static bool enableHighRes(uint8_t tries) {
+  uint8_t id[ID_LEN];
+  // Enable high-res mode (try a few times, sometimes the controller doesnt
+  // pick it up)
+  for (uint8_t i = 0; i < 3; i++) {
+    twi_writeSingleToPointer(I2C_ADDR, SET_RES_MODE, HIGHRES_MODE);
+    _delay_us(200);
+    if (i + 1 < tries) continue;
+    // Some controllers support high res mode, some dont. Some require it,
+    // some dont. When a controller goes into high res mode, its ID will
+    // change, so check.
+    memset(id, 0, sizeof(id));
+    twi_readFromPointerSlow(I2C_ADDR, READ_ID, ID_LEN, id);
+    _delay_us(200);
+    if (id[4] == HIGHRES_MODE) return true;
+  }
+  return false;
+}
+// Set when the MotionPlus has just been switched on or off, and needs some time
+// before anything will answer at I2C_ADDR again
+bool motionPlusSwitching;
+// Set when a gyro frame says an extension was plugged into or pulled out of
+// the MotionPlus, which means it has to be switched to a different mode
+bool motionPlusChanged;
+uint8_t motionPlusMode;
+void (*motionPlusExtFunction)(Controller_t *, uint8_t *) = NULL;
+uint8_t motionPlusExtOffset;
+void readMotionPlusExt(Controller_t *controller, uint8_t *data) {
+  if (bit_check(data[5], 1)) {
+    motionPlusGyro(data, micros());
+    if (bit_check(data[4], 0) != (motionPlusExtFunction != NULL)) {
+      motionPlusChanged = true;
+    }
+    return;
+  }
+  if (!motionPlusExtFunction) return;
+  motionPlusUnpack(data, motionPlusMode);
+  motionPlusExtFunction(controller, data + motionPlusExtOffset);
+}
+static bool findMotionPlus(void) {
+  uint8_t id[ID_LEN];
+  memset(id, 0, sizeof(id));
+  if (!twi_readFromPointerSlow(MOTION_PLUS_ADDR, READ_ID, ID_LEN, id)) {
+    return false;
+  }
+  return id[2] == 0xA6 && id[5] == (WII_MOTION_PLUS & 0xFF);
+}
+// Switches the MotionPlus on, passing through whatever extension initWiiExt
+// found, which then gets its frames through readMotionPlusExt
+static void activateMotionPlus(void) {
+  motionPlusMode = MOTION_PLUS_STANDALONE;
+  if (wiiExtensionID == WII_NUNCHUK) {
+    motionPlusMode = MOTION_PLUS_NUNCHUK;
+  } else if (readFunction) {
+    // Everything else passes through like a classic controller does
+    motionPlusMode = MOTION_PLUS_CLASSIC;
+  }
+  twi_writeSingleToPointer(MOTION_PLUS_ADDR, 0xF0, 0x55);
+  _delay_us(10);
+  twi_writeSingleToPointer(MOTION_PLUS_ADDR, SET_RES_MODE, motionPlusMode);
+  motionPlusExtFunction = readFunction;
+  motionPlusExtOffset = dataReadIndex;
+  readFunction = readMotionPlusExt;
+  dataReadIndex = 0;
+  bytes = 6;
+  if (!motionPlusExtFunction) { wiiExtensionID = WII_MOTION_PLUS; }
+  motionPlusSwitching = true;
 }
 void initWiiExt(void) {
+  if (wiiReadState != WII_READ_IDLE) {
+    twi_cancel();
+    wiiReadState = WII_READ_IDLE;
+  }
+  motionPlusSwitching = false;
+  motionPlusChanged = false;
   // twi_init(false);
   wiiExtensionID = readExtID();
+  if (wiiExtensionID == WII_MOTION_PLUS) {
+    // A MotionPlus that is still switched on from before hides the extension
+    // behind it, so switch it off and come back once that has happened
+    twi_writeSingleToPointer(I2C_ADDR, 0xF0, 0x55);
+    wiiExtensionID = WII_NO_EXTENSION;
+    readFunction = NULL;
+    motionPlusSwitching = true;
+    return;
+  }
+  bool motionPlus = motionPlusWanted && findMotionPlus();
   if (wiiExtensionID == WII_NOT_INITIALISED) {
     // Send packets needed to initialise a controller
     twi_writeSingleToPointer(I2C_ADDR, 0xF0, 0x55);
@@ -231,6 +348,7 @@ void initWiiExt(void) {
     _delay_us(10);
   }
   dataReadIndex = 0;
+  bytes = 6;
   if (wiiExtensionID == WII_GUITAR_HERO_GUITAR_CONTROLLER) {
     readFunction = readGuitarExt;
   } else if (wiiExtensionID == WII_CLASSIC_CONTROLLER ||
@@ -238,21 +356,15 @@ void initWiiExt(void) {
     // We know that classic controllers and classic pro controllers support
     // higher speed
     // twi_init(false);
-    // Enable high-res mode (try a few times, sometimes the controller doesnt
-    // pick it up)
-    for (int i = 0; i < 3; i++) {
-      twi_writeSingleToPointer(I2C_ADDR, SET_RES_MODE, HIGHRES_MODE);
-      _delay_us(200);
+    WiiResCache_t *res = findWiiRes(wiiExtensionID);
+    // One that took it before normally takes it straight away
+    if (res->mode != WII_RES_LOW && !motionPlus) {
+      res->mode = enableHighRes(res->mode == WII_RES_HIGH ? 1 : 3)
+                      ? WII_RES_HIGH
+                      : WII_RES_LOW;
     }
-
-    // Some controllers support high res mode, some dont. Some require it, some
-    // dont. When a controller goes into high res mode, its ID will change,
-    // so check.
-
-    uint8_t id[ID_LEN];
-    twi_readFromPointerSlow(I2C_ADDR, READ_ID, ID_LEN, id);
-    _delay_us(200);
-    if (id[4] == HIGHRES_MODE) {
+    // High res doesn't fit through the MotionPlus
+    if (res->mode == WII_RES_HIGH && !motionPlus) {
       readFunction = readClassicExtHighRes;
       bytes = 8;
     } else {
@@ -279,18 +391,125 @@ void initWiiExt(void) {
     wiiExtensionID = WII_NO_EXTENSION;
     readFunction = NULL;
   }
+  if (motionPlus) activateMotionPlus();
+  RECORD(RECORD_WII_ID, &wiiExtensionID, sizeof(wiiExtensionID));
+  // Get the first read going, so it is ready by the next tick
+  if (readFunction && !motionPlusSwitching && !wiiSharesBus) {
+    startWiiPointer();
+  }
+}
+// Moves the read along as far as it can go without waiting, and returns true
+// if data now holds a new read
+static bool pollWiiExt(uint8_t *data, bool *failed) {
+  for (;;) {
+    uint32_t now = micros();
+    switch (wiiReadState) {
+    case WII_READ_IDLE:
+      // Nothing answers while the MotionPlus is switching over
+      if ((int32_t)(millis() - wiiRetryAt) < 0) return false;
+      if (!startWiiPointer()) break;
+      continue;
+    case WII_READ_POINTER:
+    case WII_READ_DATA: {
+      uint8_t status = twi_poll(data);
+      if (status == TWI_ASYNC_FAILED) break;
+      if (status == TWI_ASYNC_BUSY) {
+        if (now - wiiReadStarted > WII_READ_TIMEOUT_US) break;
+        if (wiiSharesBus) continue;
+        return false;
+      }
+      if (wiiReadState == WII_READ_DATA) {
+        wiiReadState = WII_READ_IDLE;
+        return true;
+      }
+      // The extension only starts getting the data ready once the pointer
+      // has been written. That may have been long before this tick noticed,
+      // but it can't have taken longer than a whole write does.
+      if (now - wiiReadStarted > WII_POINTER_WRITE_US) {
+        wiiReadStarted += WII_POINTER_WRITE_US;
+      } else {
+        wiiReadStarted = now;
+      }
+      wiiReadState = WII_READ_WAIT;
+      continue;
+    }
+    case WII_READ_WAIT:
+      if (now - wiiReadStarted < TWI_POINTER_DELAY_US) return false;
+      wiiReadStarted = now;
+      wiiReadState = WII_READ_DATA;
+      if (!twi_startRead(I2C_ADDR, bytes)) break;
+      continue;
+    }
+    *failed = true;
+    return false;
+  }
+}
+static void connectWiiExt(void) {
+  uint32_t now = millis();
+  if ((int32_t)(now - wiiRetryAt) < 0) return;
+  uint8_t pointer = READ_ID;
+  // A MotionPlus that isn't switched on only answers at its own address
+  if (twi_writeTo(I2C_ADDR, &pointer, 1, true, true) ||
+      (motionPlusWanted &&
+       twi_writeTo(MOTION_PLUS_ADDR, &pointer, 1, true, true))) {
+    initWiiExt();
+    if (motionPlusSwitching) {
+      wiiBackoff = 0;
+      wiiRetryAt = now + MOTION_PLUS_SWITCH_MS;
+      return;
+    }
+    if (wiiExtensionID != WII_NO_EXTENSION) {
+      wiiBackoff = 0;
+      return;
+    }
+  }
+  wiiBackoff = wiiBackoff ? wiiBackoff * 2 : WII_BACKOFF_MIN_MS;
+  if (wiiBackoff > WII_BACKOFF_MAX_MS) { wiiBackoff = WII_BACKOFF_MAX_MS; }
+  wiiRetryAt = now + wiiBackoff;
+}
+// A read failing is often just a glitch, so the extension is looked for again
+// straight away, and only backs off if it really has gone
+static void lostWiiExt(void) {
+  if (wiiReadState != WII_READ_IDLE) {
+    twi_cancel();
+    wiiReadState = WII_READ_IDLE;
+  }
+  wiiExtensionID = WII_NO_EXTENSION;
+  wiiRetryAt = millis();
+  connectWiiExt();
 }
 void tickWiiExtInput(Controller_t *controller) {
   uint8_t data[8];
   memset(data, 0, sizeof(data));
+  bool failed = false;
   if (wiiExtensionID == WII_NOT_INITIALISED ||
-      wiiExtensionID == WII_NO_EXTENSION ||
-      !twi_readFromPointerSlow(I2C_ADDR, dataReadIndex, bytes, data) ||
-      !verifyData(data, bytes)) {
-    initWiiExt();
+      wiiExtensionID == WII_NO_EXTENSION) {
+    connectWiiExt();
+    return;
+  }
+  // Until the next read is in, the controller keeps the last one
+  if (!pollWiiExt(data, &failed)) {
+    if (failed) lostWiiExt();
     return;
   }
+  if (!verifyData(data, bytes)) {
+    lostWiiExt();
+    return;
+  }
+  // Set up the next read while this one is being used
+  startWiiPointer();
+  bool nextFailed = false;
+  if (wiiSharesBus) {
+    uint8_t next[8];
+    pollWiiExt(next, &nextFailed);
+  }
+#ifdef RECORD_INPUTS
+  uint8_t record[sizeof(data) + 1] = {dataReadIndex};
+  memcpy(record + 1, data, bytes);
+  RECORD(RECORD_WII, record, bytes + 1);
+#endif
   if (readFunction) readFunction(controller, data);
+  if (motionPlusChanged || nextFailed) lostWiiExt();
 }
 bool readWiiButton(Pin_t *pin) {
   uint8_t idx = wiiButtonBindings[pin->offset];
@@ -300,4 +519,7 @@ bool readWiiButton(Pin_t *pin) {
 void initWiiExtensions(Configuration_t *config) {
   mapNunchukAccelToRightJoy = config->main.mapNunchukAccelToRightJoy;
   guitarTapBar = config->neck.wiiNeck;
+  initMotionPlus(config);
+  wiiSharesBus = typeIsDJ || config->neck.gh5Neck ||
+                 config->neck.gh5NeckBar || config->main.tiltType == MPU_6050;
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+#include "controller/controller.h"
+#include "util/util.h"
+// Where each field of a wii extension report ends up, as a table per extension
+// that WII_DECODE turns into straight line code at compile time. A layout is a
+// list of FIELDs, each followed by the PARTs it is built from:
+//
+//   FIELD(dest, invert, bias, shift, mask)
+//   PART(dest, byte, mask, right, left)
+//
+// Every PART of a field is ((data[byte] & mask) >> right) << left, and they are
+// ORed together. The field is then XORed with invert, has bias added to it, is
+// shifted left by shift and finally ANDed with mask before being stored in
+// dest. All of that is done in an int, the same as the hand written decoders
+// these replaced did, so the results are the same to the bit on every platform.
+//
+// Anything that isn't just moving bits around (the whammy curve, tap bars,
+// drum velocities, turntables) is still code, run after the layout.
+#define WII_DEST_l_x controller->l_x
+#define WII_DEST_l_y controller->l_y
+#define WII_DEST_r_x controller->r_x
+#define WII_DEST_r_y controller->r_y
+#define WII_DEST_lt controller->lt
+#define WII_DEST_rt controller->rt
+#define WII_DEST_buttons buttons
+#define WII_SKIP(...)
+#define WII_DECLARE(dest, invert, bias, shift, mask) int wii_##dest = 0;
+#define WII_PART(dest, byte, mask, right, left)                                \
+  wii_##dest |= ((data[byte] & (mask)) >> (right)) << (left);
+#define WII_STORE(dest, invert, bias, shift, mask)                             \
+  WII_DEST_##dest = ((((wii_##dest) ^ (invert)) + (bias)) << (shift)) & (mask);
+#define WII_DECODE(LAYOUT)                                                     \
+  LAYOUT(WII_DECLARE, WII_SKIP)                                                \
+  LAYOUT(WII_SKIP, WII_PART)                                                   \
+  LAYOUT(WII_STORE, WII_SKIP)
+
+#define WII_CLASSIC_LAYOUT(FIELD, PART)                                        \
+  FIELD(l_x, 0, -32, 0, -1)                                                    \
+  PART(l_x, 0, 0x3F, 0, 0)                                                     \
+  FIELD(l_y, 0, -32, 0, -1)                                                    \
+  PART(l_y, 1, 0x3F, 0, 0)                                                     \
+  FIELD(r_x, 0, -16, 10, -1)                                                   \
+  PART(r_x, 0, 0xC0, 3, 0)                                                     \
+  PART(r_x, 1, 0xC0, 5, 0)                                                     \
+  PART(r_x, 2, 0xFF, 7, 0)                                                     \
+  FIELD(r_y, 0, -16, 10, -1)                                                   \
+  PART(r_y, 2, 0x1F, 0, 0)                                                     \
+  FIELD(lt, 0, 0, 0, -1)                                                       \
+  PART(lt, 3, 0xFF, 5, 0)                                                      \
+  PART(lt, 2, 0x60, 2, 0)                                                      \
+  FIELD(rt, 0, 0, 0, -1)                                                       \
+  PART(rt, 3, 0x1F, 0, 0)                                                      \
+  FIELD(buttons, -1, 0, 0, -1)                                                 \
+  PART(buttons, 4, 0xFF, 0, 0)                                                 \
+  PART(buttons, 5, 0xFF, 0, 8)
+
+#define WII_CLASSIC_HIGH_RES_LAYOUT(FIELD, PART)                               \
+  FIELD(l_x, 0, -0x80, 8, -1)                                                  \
+  PART(l_x, 0, 0xFF, 0, 0)                                                     \
+  FIELD(l_y, 0, -0x80, 8, -1)                                                  \
+  PART(l_y, 2, 0xFF, 0, 0)                                                     \
+  FIELD(r_x, 0, -0x80, 8, -1)                                                  \
+  PART(r_x, 1, 0xFF, 0, 0)                                                     \
+  FIELD(r_y, 0, -0x80, 8, -1)                                                  \
+  PART(r_y, 3, 0xFF, 0, 0)                                                     \
+  FIELD(lt, 0, 0, 0, -1)                                                       \
+  PART(lt, 4, 0xFF, 0, 0)                                                      \
+  FIELD(rt, 0, 0, 0, -1)                                                       \
+  PART(rt, 5, 0xFF, 0, 0)                                                      \
+  FIELD(buttons, -1, 0, 0, -1)                                                 \
+  PART(buttons, 6, 0xFF, 0, 0)                                                 \
+  PART(buttons, 7, 0xFF, 0, 8)
+
+#define WII_GUITAR_LAYOUT(FIELD, PART)                                         \
+  FIELD(l_x, 0, -32, 10, -1)                                                   \
+  PART(l_x, 0, 0x3F, 0, 0)                                                     \
+  FIELD(l_y, 0, -32, 10, -1)                                                   \
+  PART(l_y, 1, 0x3F, 0, 0)                                                     \
+  FIELD(buttons, -1, 0, 0, -1)                                                 \
+  PART(buttons, 4, 0xFF, 0, 0)                                                 \
+  PART(buttons, 5, 0xFF, 0, 8)
+
+// Bit 8 isn't used by the drums
+#define WII_DRUM_LAYOUT(FIELD, PART)                                           \
+  FIELD(l_x, 0, -0x20, 10, -1)                                                 \
+  PART(l_x, 0, 0xFF, 0, 0)                                                     \
+  FIELD(l_y, 0, -0x20, 10, -1)                                                 \
+  PART(l_y, 1, 0xFF, 0, 0)                                                     \
+  FIELD(buttons, -1, 0, 0, 0xFEFF)                                             \
+  PART(buttons, 4, 0xFF, 0, 0)                                                 \
+  PART(buttons, 5, 0xFF, 0, 8)
+
+#define WII_NUNCHUK_LAYOUT(FIELD, PART)                                        \
+  FIELD(l_x, 0, -0x80, 8, -1)                                                  \
+  PART(l_x, 0, 0xFF, 0, 0)                                                     \
+  FIELD(l_y, 0, -0x80, 8, -1)                                                  \
+  PART(l_y, 1, 0xFF, 0, 0)                                                     \
+  FIELD(buttons, _BV(WII_A) | _BV(WII_B), 0, 0, -1)                            \
+  PART(buttons, 5, 0x01, 0, WII_A)                                             \
+  PART(buttons, 5, 0x02, 1, WII_B)
+
+// The turntables themselves and the stick (which drives the dpad) are code
+#define WII_DJ_LAYOUT(FIELD, PART)                                             \
+  FIELD(r_x, 0, 0, 0, -1)                                                      \
+  PART(r_x, 3, 0xE0, 5, 0)                                                     \
+  PART(r_x, 2, 0x60, 2, 0)                                                     \
+  FIELD(r_y, 0, 0, 0, -1)                                                      \
+  PART(r_y, 2, 0x1E, 1, 0)                                                     \
+  FIELD(buttons, -1, 0, 0, 0x63CD)                                             \
+  PART(buttons, 4, 0xFF, 0, 8)                                                 \
+  PART(buttons, 5, 0xFF, 0, 0)
+
+// The pen buttons are active high, apart from the one on the tablet itself
+#define WII_UDRAW_LAYOUT(FIELD, PART)                                          \
+  FIELD(l_x, 0, 0, 0, -1)                                                      \
+  PART(l_x, 2, 0x0F, 0, 8)                                                     \
+  PART(l_x, 0, 0xFF, 0, 0)                                                     \
+  FIELD(l_y, 0, 0, 0, -1)                                                      \
+  PART(l_y, 2, 0xF0, 0, 4)                                                     \
+  PART(l_y, 1, 0xFF, 0, 0)                                                     \
+  FIELD(rt, 0, 0, 0, -1)                                                       \
+  PART(rt, 3, 0xFF, 0, 0)                                                      \
+  FIELD(buttons, _BV(WII_Y), 0, 0, -1)                                         \
+  PART(buttons, 5, 0x01, 0, WII_A)                                             \
+  PART(buttons, 5, 0x02, 1, WII_B)                                             \
+  PART(buttons, 5, 0x04, 2, WII_Y)
+
+// The pressure is 12 bits, but only the bottom 8 fit in rt
+#define WII_DRAWSOME_LAYOUT(FIELD, PART)                                       \
+  FIELD(l_x, 0, 0, 0, -1)                                                      \
+  PART(l_x, 0, 0xFF, 0, 0)                                                     \
+  PART(l_x, 1, 0xFF, 0, 8)                                                     \
+  FIELD(l_y, 0, 0, 0, -1)                                                      \
+  PART(l_y, 2, 0xFF, 0, 0)                                                     \
+  PART(l_y, 3, 0xFF, 0, 8)                                                     \
+  FIELD(rt, 0, 0, 0, -1)                                                       \
+  PART(rt, 4, 0xFF, 0, 0)                                                      \
+  PART(rt, 5, 0x0F, 0, 8)
+
+// Only the button byte is read from these
+#define WII_TATACON_LAYOUT(FIELD, PART)                                        \
+  FIELD(buttons, -1, 0, 0, -1)                                                 \
+  PART(buttons, 0, 0xFF, 0, 0)
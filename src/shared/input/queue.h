@@ -0,0 +1,93 @@
+#pragma once
+#include "timer/timer.h"
+#include <stdbool.h>
+#include <stdint.h>
+// Queues up changes to the frets for deque mode, so that none are lost when
+// they change faster than the host polls. Every change is stored along with
+// the time since the previous one, and they are played back with the same
+// spacing. Changes closer together than a poll get pushed back to the next
+// one, and the rest of the queue moves with them, but only until the queue is
+// QUEUE_MAX_LAG_POLLS behind. After that changes are sent once per poll until
+// it catches up. The queue starts from scratch whenever it empties.
+//
+// Deltas are stored in 100us units, anything longer than that just means the
+// queue was idle.
+#define QUEUE_SIZE 64
+#define QUEUE_UNIT_US 100
+#define QUEUE_MAX_LAG_POLLS 8
+typedef struct {
+  uint8_t delta;
+  uint8_t buttons;
+} QueueEvent_t;
+QueueEvent_t queue[QUEUE_SIZE];
+uint8_t queueHead;
+uint8_t queueSize;
+uint8_t lastQueue;
+// What the host was last sent
+uint8_t queueOutput;
+// When the last change was pushed
+uint32_t lastQueueEvent;
+// When the last change that was sent was pushed, and when it was sent
+uint32_t queueCaptured;
+uint32_t queueReleased;
+uint32_t queuePollRate;
+void initQueue(uint32_t pollRate) {
+  queuePollRate = pollRate;
+  queueHead = 0;
+  queueSize = 0;
+  lastQueue = 0;
+  queueOutput = 0;
+  lastQueueEvent = micros();
+  queueCaptured = lastQueueEvent;
+  queueReleased = lastQueueEvent;
+}
+// Called every tick with the current state of the frets
+void pushQueue(uint8_t buttons) {
+  if (buttons == lastQueue) return;
+  lastQueue = buttons;
+  uint32_t now = micros();
+  uint32_t elapsed = now - lastQueueEvent;
+  uint8_t units;
+  if (elapsed >= UINT8_MAX * QUEUE_UNIT_US) {
+    units = UINT8_MAX;
+    lastQueueEvent = now;
+  } else {
+    units = (uint16_t)elapsed / QUEUE_UNIT_US;
+    lastQueueEvent += units * QUEUE_UNIT_US;
+  }
+  if (!queueSize) {
+    // Nothing is waiting, so this can go out as soon as it is due
+    queueCaptured = now - units * QUEUE_UNIT_US;
+    queueReleased = queueCaptured;
+  }
+  if (queueSize == QUEUE_SIZE) {
+    // Out of room, so the newest change just gets replaced
+    queue[(queueHead + queueSize - 1) % QUEUE_SIZE].buttons = buttons;
+    return;
+  }
+  QueueEvent_t *event = &queue[(queueHead + queueSize) % QUEUE_SIZE];
+  event->delta = units;
+  event->buttons = buttons;
+  queueSize++;
+}
+// Called once per poll, returns true if the frets should be replaced with
+// queueOutput, as the queue is behind the current state.
+bool tickQueue(void) {
+  if (!queueSize) return false;
+  QueueEvent_t *event = &queue[queueHead];
+  uint32_t delta = event->delta * QUEUE_UNIT_US;
+  uint32_t now = micros();
+  // Send it on whichever poll is closest to when it is due
+  if ((int32_t)(now + queuePollRate / 2 - (queueReleased + delta)) >= 0) {
+    queueOutput = event->buttons;
+    queueCaptured += delta;
+    queueReleased = now;
+    int32_t maxLag = queuePollRate * QUEUE_MAX_LAG_POLLS;
+    if ((int32_t)(queueReleased - queueCaptured) > maxLag) {
+      queueReleased = queueCaptured + maxLag;
+    }
+    queueHead = (queueHead + 1) % QUEUE_SIZE;
+    queueSize--;
+  }
+  return true;
+}
@@ -8,12 +8,31 @@ void resetConfig(void);
 void writeConfigBlock(uint16_t offset, const uint8_t *data, uint16_t len);
 void writeConfigByte(uint16_t offset, uint8_t byte);
 void readConfigBlock(uint16_t offset, uint8_t *data, uint16_t len);
+// Makes sure everything written so far is stored. The pico only keeps partial
+// writes in ram until a write reaches the end of the config, so anything else
+// writing part of the config needs to call this once it is done.
+void commitConfig(void);
 extern bool isRF;
 extern uint8_t inputType;
 extern uint8_t deviceType;
+// Build with BAKED_CONFIG defined, and the directory holding a baked_config.h
+// generated by ardwiino_bake (src/host/bake) on the include path, to build an
+// image that only ever runs the config it was generated from. loadConfig then
+// ignores whatever is stored, and anything that only depends on the config
+// becomes a constant, so code for other devices and inputs can be dropped.
+#ifdef BAKED_CONFIG
+#  include "baked_config.h"
+static const uint8_t fullDeviceType = BAKED_SUB_TYPE;
+static const bool typeIsGuitar = BAKED_TYPE_IS_GUITAR;
+static const bool typeIsDrum = BAKED_TYPE_IS_DRUM;
+static const bool typeIsDJ = BAKED_TYPE_IS_DJ;
+#  define CONFIG_INPUT_TYPE(config) ((uint8_t)BAKED_INPUT_TYPE)
+#else
 extern uint8_t fullDeviceType;
 extern bool typeIsGuitar;
 extern bool typeIsDrum;
 extern bool typeIsDJ;
+#  define CONFIG_INPUT_TYPE(config) ((config)->main.inputType)
+#endif
 extern Led_t leds[XBOX_BTN_COUNT + XBOX_AXIS_COUNT];
 extern uint8_t drumVelocity[8];
\ No newline at end of file
@@ -38,6 +38,17 @@
 #define TWI_SRX 3
 #define TWI_STX 4
 
+// How long an extension needs after its pointer is set before it can be read
+#ifdef PICO
+#  define TWI_POINTER_DELAY_US 170
+#else
+#  define TWI_POINTER_DELAY_US 180
+#endif
+
+#define TWI_ASYNC_BUSY 0
+#define TWI_ASYNC_DONE 1
+#define TWI_ASYNC_FAILED 2
+
 void twi_init(bool fivetar, bool dj);
 void twi_disable(void);
 bool twi_readFrom(uint8_t, uint8_t *, uint8_t, uint8_t);
@@ -50,5 +61,12 @@ bool twi_readFromPointerSlow(uint8_t address, uint8_t pointer, uint8_t length,
 bool twi_writeSingleToPointer(uint8_t address, uint8_t pointer, uint8_t data);
 bool twi_writeToPointer(uint8_t address, uint8_t pointer, uint8_t length,
                         uint8_t *data);
+// Start a transfer without waiting for it, and then call twi_poll until it
+// stops returning TWI_ASYNC_BUSY. Only one can be running at a time, and
+// twi_cancel gives up on it so that the bus can be used for something else.
+bool twi_startWrite(uint8_t address, uint8_t *data, uint8_t length);
+bool twi_startRead(uint8_t address, uint8_t length);
+uint8_t twi_poll(uint8_t *data);
+void twi_cancel(void);
 
 #endif
@@ -14,8 +14,6 @@ typedef struct {
   bool eq;
   uint8_t pin;
   uint8_t offset;
-  uint32_t lastMillis;
-  uint8_t milliDeBounce;
   uint8_t analogOffset;
 } Pin_t;
 #else
@@ -26,12 +24,16 @@ typedef struct {
   bool eq;
   uint8_t offset;
   uint8_t pin;
-  uint32_t lastMillis;
-  uint8_t milliDeBounce;
   bool sioFunc;
   uint8_t analogOffset;
 } Pin_t;
 #endif
+// A port is a group of pins that can all be read at the same time
+#ifdef __AVR__
+typedef uint8_t port_t;
+#else
+typedef uint32_t port_t;
+#endif
 typedef struct {
   uint8_t offset;
   uint8_t pin;
@@ -61,4 +63,21 @@ void setUpAnalogDigitalPin(Pin_t* button, uint8_t pin, uint16_t threshold);
 void setUpDigital(Pin_t* pin, Configuration_t* config, uint8_t pin_num, uint8_t offset, bool inverted, bool output);
 void digitalWritePin(Pin_t* pin, bool value);
 void digitalWrite(uint8_t pin, uint8_t value);
-unsigned long digitalReadPulse(Pin_t* pin, uint8_t state, unsigned long timeout);
\ No newline at end of file
+unsigned long digitalReadPulse(Pin_t* pin, uint8_t state, unsigned long timeout);
+uint8_t pinPort(Pin_t* pin);
+uint8_t pinBit(Pin_t* pin);
+port_t readPort(uint8_t port);
+// The same as pinPort and pinBit, but for a pin number, and with the bit as a
+// mask, for pins that haven't been set up as a Pin_t
+uint8_t digitalPinPort(uint8_t pin);
+port_t digitalPinMask(uint8_t pin);
+// Puts every pin in mask into INPUT_PULLUP at once
+void pullUpPort(uint8_t port, port_t mask);
+// Only with CAPTURE_EDGES. Once a pin is enabled, the platform calls
+// pinChanged from an interrupt with the new value of its port whenever it
+// changes. Returns false if the pin can't do this.
+bool enablePinChange(Pin_t* pin);
+void pinChanged(uint8_t port, port_t value);
+// Only with ADC_SCAN. The platform calls drumSampled with every sample it takes
+// of a pin set up with setUpAnalogDigitalPin, and when it was taken.
+void drumSampled(uint8_t analog, uint16_t value, uint32_t now);
\ No newline at end of file
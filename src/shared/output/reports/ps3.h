@@ -5,11 +5,16 @@
 #include "eeprom/eeprom.h"
 #include "output/controller_structs.h"
 // Bindings to go from controller to ps3
+#ifdef BAKED_CONFIG
+// Already worked out by initPS3 when the config was baked
+static const uint8_t ps3ButtonBindings[] = {BAKED_PS3_BUTTON_BINDINGS};
+#else
 static uint8_t ps3ButtonBindings[] = {
     XBOX_Y,    XBOX_A,     XBOX_B,          XBOX_X,
     0xff,      0xff,       XBOX_LB,         XBOX_RB,
     XBOX_BACK, XBOX_START, XBOX_LEFT_STICK, XBOX_RIGHT_STICK,
     XBOX_HOME, XBOX_UNUSED};
+#endif
 static const uint8_t PROGMEM psGHButtonBindings[] = {
     XBOX_Y,     XBOX_A,          XBOX_B,
     XBOX_X,     XBOX_LB,         0xff,
@@ -37,10 +42,12 @@ static const uint8_t PROGMEM ps3DrumButtonBindings[] = {XBOX_X,
                                                         XBOX_RIGHT_STICK,
                                                         XBOX_HOME,
                                                         XBOX_UNUSED};
+#ifndef BAKED_CONFIG
 static uint8_t ps3AxisBindings[] = {
     XBOX_DPAD_UP, XBOX_DPAD_RIGHT, XBOX_DPAD_DOWN, XBOX_DPAD_LEFT, 0xFF,
     0xFF,         XBOX_LB,         XBOX_RB,        XBOX_Y,         XBOX_B,
     XBOX_A,       XBOX_X};
+#endif
 static const uint8_t ghAxisBindings[] = {XBOX_DPAD_LEFT,  XBOX_DPAD_DOWN,
                                          XBOX_DPAD_RIGHT, XBOX_DPAD_UP,
                                          XBOX_X,          XBOX_B};
@@ -53,6 +60,7 @@ static const uint8_t hat_bindings[] = {0x08, 0x00, 0x04, 0x08, 0x06, 0x07,
 uint8_t currentAxisBindingsLen = 0;
 bool isPs3 = false;
 void initPS3(void) {
+#ifndef BAKED_CONFIG
   if (fullDeviceType > SWITCH_GAMEPAD) {
     if (fullDeviceType > PS3_GAMEPAD) {
       memcpy_P(ps3AxisBindings, ghAxisBindings, sizeof(ghAxisBindings));
@@ -73,6 +81,7 @@ void initPS3(void) {
              fullDeviceType == WII_ROCK_BAND_GUITAR) {
     memcpy_P(ps3ButtonBindings, psRBButonBindings, sizeof(ps3ButtonBindings));
   }
+#endif
 }
 void fillPS3Report(void *ReportData, uint8_t *const ReportSize,
                    Controller_t *controller) {
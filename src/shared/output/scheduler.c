@@ -0,0 +1,95 @@
+#include "scheduler.h"
+#include "stats/stats.h"
+#include "timer/timer.h"
+#include "util/util.h"
+// If no start of frame has been seen for this long, go back to the timer
+#define SOF_TIMEOUT_US (SOF_PERIOD_US * 4)
+// Extra time left before the frame starts, to soak up anything not measured
+#define SOF_GUARD_US 50
+// Where the last start of frame is thought to have happened. On the pico the
+// callback is run from tud_task, so it can only ever be late. The estimate
+// snaps to anything earlier than predicted, and only slowly follows anything
+// later, so that it ends up tracking the earliest callbacks.
+static volatile uint32_t sofTime;
+static volatile uint16_t sofCount;
+static volatile bool sofSeen;
+// Time between the last report being handed over and the next start of frame
+static volatile uint16_t sofWait;
+static volatile bool sofWaitReady;
+static bool reportWaiting;
+static uint32_t reportSentAt;
+// The frame the last report was lined up for
+static uint16_t reportFrame;
+static uint32_t lastReport;
+static uint32_t dueAt;
+static uint32_t lastCall;
+// Running averages of the time from a report being due to it being sent, and
+// of the time between ticks, with three extra bits of precision
+static uint32_t lead8;
+static uint32_t loop8;
+
+void schedulerStartOfFrame(void) {
+  uint32_t now = micros();
+  int32_t error = now - (sofTime + SOF_PERIOD_US);
+  if (!sofSeen || error < 0 || error > SOF_PERIOD_US / 2) {
+    sofTime = now;
+  } else {
+    sofTime += SOF_PERIOD_US + error / 8;
+  }
+  sofSeen = true;
+  sofCount++;
+  if (reportWaiting) {
+    reportWaiting = false;
+    int32_t wait = sofTime - reportSentAt;
+    sofWait = wait > 0 ? wait : 0;
+    sofWaitReady = true;
+  }
+}
+
+bool schedulerReportDue(uint32_t pollRate) {
+  uint32_t now = micros();
+  uint32_t loop = now - lastCall;
+  if (loop > SOF_PERIOD_US / 2) { loop = SOF_PERIOD_US / 2; }
+  loop8 += loop - (loop8 >> 3);
+  lastCall = now;
+  cli();
+  uint32_t lastSof = sofTime;
+  uint16_t frame = sofCount;
+  bool seen = sofSeen;
+  bool waitReady = sofWaitReady;
+  uint16_t wait = sofWait;
+  sofWaitReady = false;
+  sei();
+  if (waitReady) { statsFrameWait(wait); }
+  if (!seen || now - lastSof > SOF_TIMEOUT_US) {
+    if (now - lastReport < pollRate) { return false; }
+    lastReport = now;
+    dueAt = now;
+    return true;
+  }
+  uint16_t frames = pollRate / SOF_PERIOD_US;
+  if (!frames) { frames = 1; }
+  // The next frame already has a report lined up for it
+  if ((uint16_t)(frame + 1 - reportFrame) < frames) { return false; }
+  // Fire early enough that, even if the next tick is the one that notices, the
+  // report is sent before the frame starts.
+  uint32_t needed = (lead8 >> 3) + (loop8 >> 3) + SOF_GUARD_US;
+  int32_t untilSof = lastSof + SOF_PERIOD_US - now;
+  if (untilSof > (int32_t)needed) { return false; }
+  reportFrame = frame + 1;
+  lastReport = now;
+  dueAt = now;
+  return true;
+}
+
+void schedulerReportSent(void) {
+  uint32_t now = micros();
+  uint32_t lead = now - dueAt;
+  // A slow report shouldn't push every report after it out for long
+  if (lead > SOF_PERIOD_US / 2) { lead = SOF_PERIOD_US / 2; }
+  lead8 += lead - (lead8 >> 3);
+  cli();
+  reportSentAt = now;
+  reportWaiting = true;
+  sei();
+}
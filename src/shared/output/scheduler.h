@@ -0,0 +1,16 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+// Decides when tickInputs should hand over a report. When the usb stack tells
+// us about start of frame packets, reports are lined up with the host's
+// polling, so that the last sample is taken and the report is filled just
+// before the frame it will be sent in starts, instead of sitting in the
+// endpoint for a random part of a frame. Without start of frames (no usb, or
+// not enumerated yet) this falls back to a free running timer.
+#define SOF_PERIOD_US 1000
+// Called from the start of frame interrupt / callback
+void schedulerStartOfFrame(void);
+// Called at the end of every tick, with the poll rate in microseconds
+bool schedulerReportDue(uint32_t pollRate);
+// Called once the report has been handed to the usb stack
+void schedulerReportSent(void);
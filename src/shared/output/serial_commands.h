@@ -16,7 +16,12 @@ enum SerialCommands {
     COMMAND_GET_VALUES,
     COMMAND_WRITE_CONFIG,
     COMMAND_READ_CONFIG,
-    MAX
+    MAX,
+    // Every command from COMMAND_READ_CONFIG up is treated as a config block
+    // index, so anything newer needs to live well past the end of the config.
+    COMMAND_GET_STATS = 0x60,
+    COMMAND_GET_TRACE,
+    COMMAND_GET_RECORDING
 };
 typedef struct {
     uint32_t cpu_freq;
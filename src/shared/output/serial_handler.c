@@ -5,6 +5,9 @@
 #include "leds/leds.h"
 #include "rf/rf.h"
 #include "serial_commands.h"
+#include "stats/record.h"
+#include "stats/stats.h"
+#include "stats/trace.h"
 #include "timer/timer.h"
 #include "util/util.h"
 #include <stdlib.h>
@@ -46,6 +49,9 @@ void processHIDWriteFeatureReport(uint8_t cmd, uint8_t data_len,
     uint16_t offset = (*data) * PACKET_SIZE;
     data++;
     data_len--;
+    // Ignore anything that would go past the end of leds
+    if (offset >= sizeof(leds)) return;
+    if (data_len > sizeof(leds) - offset) { data_len = sizeof(leds) - offset; }
     uint8_t *dest = ((uint8_t *)leds) + offset;
     while (data_len--) { *(dest++) = *(data++); }
     return;
@@ -86,7 +92,15 @@ void processHIDReadFeatureReport(uint8_t cmd, uint8_t report,
   }
   uint8_t size;
   dbuf[0] = REPORT_ID_CONTROL;
-  if (cmd >= COMMAND_READ_CONFIG) {
+  if (cmd == COMMAND_GET_STATS) {
+    size = sizeof(Stats_t) + 1;
+    memcpy(dbuf + 1, &stats, sizeof(Stats_t));
+    resetStats();
+  } else if (cmd == COMMAND_GET_TRACE) {
+    size = readTrace(dbuf + 1) + 1;
+  } else if (cmd == COMMAND_GET_RECORDING) {
+    size = readRecording(dbuf + 1, sizeof(dbuf) - 1) + 1;
+  } else if (cmd >= COMMAND_READ_CONFIG) {
     size = 50;
     uint16_t index = size * (cmd - COMMAND_READ_CONFIG);
     int16_t size2 = sizeof(Configuration_t) - index;
@@ -113,8 +127,10 @@ void processHIDReadFeatureReport(uint8_t cmd, uint8_t report,
       dbuf[2] = 0;
     }
   } else if (cmd == COMMAND_GET_FOUND) {
+    // Older configurators only look at the first pin
     size = 2;
     dbuf[1] = detectedPin;
+    for (uint8_t i = 1; i < foundCount; i++) { dbuf[size++] = foundPins[i]; }
     stopSearching();
   } else if (cmd == 0) {
     isPs3 = true;
@@ -0,0 +1,59 @@
+#include "record.h"
+#include <string.h>
+#ifdef RECORD_INPUTS
+#  include "timer/timer.h"
+static uint8_t ring[RECORD_BUFFER_SIZE];
+static uint16_t head = 0;
+static uint16_t used = 0;
+static uint8_t flags = 0;
+static uint32_t lastRecord = 0;
+static uint32_t tickStart = 0;
+static void ringWrite(const uint8_t *data, uint8_t len) {
+  while (len--) {
+    ring[(head + used++) % RECORD_BUFFER_SIZE] = *data++;
+  }
+}
+static void ringRead(uint8_t *data, uint8_t len) {
+  while (len--) {
+    *data++ = ring[head];
+    head = (head + 1) % RECORD_BUFFER_SIZE;
+    used--;
+  }
+}
+// Called at the start of tickInputs
+void recordTick(void) { tickStart = micros(); }
+void recordInput(uint8_t type, const void *data, uint8_t len) {
+  // Drop the new record rather than an old one, so that whatever is read back
+  // is always a contiguous run of records
+  if (used + sizeof(RecordHeader_t) + len > RECORD_BUFFER_SIZE) {
+    flags |= RECORD_FLAG_OVERFLOW;
+    return;
+  }
+  uint32_t delta = tickStart - lastRecord;
+  lastRecord = tickStart;
+  RecordHeader_t header = {
+      .type = type, .len = len, .delta = delta > 0xFFFF ? 0xFFFF : delta};
+  ringWrite((const uint8_t *)&header, sizeof(header));
+  ringWrite(data, len);
+}
+uint8_t readRecording(uint8_t *buf, uint8_t max) {
+  uint8_t size = 1;
+  *buf++ = flags;
+  flags = 0;
+  while (used) {
+    // The length lives in the second byte of the header
+    uint8_t len = sizeof(RecordHeader_t) + ring[(head + 1) % RECORD_BUFFER_SIZE];
+    if (size + len > max) break;
+    ringRead(buf, len);
+    buf += len;
+    size += len;
+  }
+  return size;
+}
+#else
+uint8_t readRecording(uint8_t *buf, uint8_t max) {
+  (void)max;
+  *buf = 0;
+  return 1;
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+// Captures what the input pipeline sees, so that a play session can be fed
+// back through the shared code on the host (see src/host/replay). Build with
+// RECORD_INPUTS defined to enable it, otherwise RECORD compiles away to
+// nothing and COMMAND_GET_RECORDING just returns no records.
+enum RecordType {
+  // A Controller_t, recorded every time tickInputs produces a report
+  RECORD_CONTROLLER = 1,
+  // The wii extension id, recorded whenever the extension is (re)initialised
+  RECORD_WII_ID,
+  // The register the read started at, followed by the raw extension bytes
+  RECORD_WII,
+  // A full PSX poll reply, starting with the id byte
+  RECORD_PS2
+};
+#pragma pack(push, 1)
+typedef struct {
+  uint8_t type;
+  uint8_t len;
+  // Microseconds since the tick that made the previous record, saturating.
+  // Every record made during a tick is stamped with the time the tick started,
+  // so records from the same tick have a delta of 0.
+  uint16_t delta;
+} RecordHeader_t;
+#pragma pack(pop)
+// Set in the first byte returned by readRecording if records were dropped
+#define RECORD_FLAG_OVERFLOW 1
+#ifdef RECORD_INPUTS
+#  ifdef __AVR__
+#    define RECORD_BUFFER_SIZE 256
+#  else
+#    define RECORD_BUFFER_SIZE 4096
+#  endif
+void recordTick(void);
+void recordInput(uint8_t type, const void *data, uint8_t len);
+#  define RECORD_TICK() recordTick()
+#  define RECORD(type, data, len) recordInput(type, data, len)
+#else
+#  define RECORD_TICK()
+#  define RECORD(type, data, len)
+#endif
+// Writes the flags followed by as many whole records (oldest first) as fit in
+// max bytes into buf, and returns the amount of bytes written. Records that
+// are returned are removed from the buffer.
+uint8_t readRecording(uint8_t *buf, uint8_t max);
@@ -0,0 +1,53 @@
+#include "stats.h"
+#include "timer/timer.h"
+#include <string.h>
+Stats_t stats = {.latencyMin = UINT16_MAX};
+static uint16_t lastLoop;
+static uint16_t inputReady;
+static bool reportPending;
+// Average is kept with three extra bits of precision
+static uint32_t latencyAvg8;
+static uint32_t frameWaitAvg8;
+static bool frameWaitSeen;
+static void saturatingInc(uint16_t *count) {
+  if (*count != UINT16_MAX) { (*count)++; }
+}
+void tickStats(void) {
+  // Only the bottom 16 bits are kept, which is plenty for a single iteration
+  uint16_t now = micros();
+  uint16_t dt = now - lastLoop;
+  lastLoop = now;
+  uint8_t bucket = 0;
+  while (dt >>= 1) { bucket++; }
+  saturatingInc(&stats.loopTime[bucket]);
+}
+// While a report is still waiting to go out, latency is measured from the
+// first input that was ready for it, not the latest
+void statsInputReady(void) {
+  if (reportPending) return;
+  inputReady = micros();
+  reportPending = true;
+}
+void statsReportSent(void) {
+  if (!reportPending) return;
+  reportPending = false;
+  uint16_t dt = (uint16_t)micros() - inputReady;
+  if (dt < stats.latencyMin) { stats.latencyMin = dt; }
+  if (dt > stats.latencyMax) { stats.latencyMax = dt; }
+  if (!stats.reports) { latencyAvg8 = (uint32_t)dt << 3; }
+  latencyAvg8 += dt - (latencyAvg8 >> 3);
+  stats.latencyAvg = latencyAvg8 >> 3;
+  saturatingInc(&stats.reports);
+}
+void statsFrameWait(uint16_t wait) {
+  if (wait > stats.frameWaitMax) { stats.frameWaitMax = wait; }
+  if (!frameWaitSeen) { frameWaitAvg8 = (uint32_t)wait << 3; }
+  frameWaitSeen = true;
+  frameWaitAvg8 += wait - (frameWaitAvg8 >> 3);
+  stats.frameWaitAvg = frameWaitAvg8 >> 3;
+}
+void resetStats(void) {
+  memset(&stats, 0, sizeof(stats));
+  frameWaitSeen = false;
+  stats.latencyMin = UINT16_MAX;
+}
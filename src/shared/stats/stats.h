@@ -0,0 +1,28 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+// Main loop iteration times are sorted into power of two buckets (in
+// microseconds), so bucket n counts iterations that took [2^n, 2^(n+1)) us,
+// with everything from 2^15 up landing in the last bucket.
+#define STATS_BUCKETS 16
+#pragma pack(push, 1)
+typedef struct {
+  uint16_t loopTime[STATS_BUCKETS];
+  // Time from tickInputs returning true to the report being handed over to
+  // the usb stack (or the usb serial chip on the uno), in microseconds
+  uint16_t latencyMin;
+  uint16_t latencyMax;
+  uint16_t latencyAvg;
+  uint16_t reports;
+  // Time from a report being handed over to the next start of frame, in
+  // microseconds. Only counted once the host is sending start of frames.
+  uint16_t frameWaitMax;
+  uint16_t frameWaitAvg;
+} Stats_t;
+#pragma pack(pop)
+extern Stats_t stats;
+void tickStats(void);
+void statsInputReady(void);
+void statsReportSent(void);
+void statsFrameWait(uint16_t wait);
+void resetStats(void);
@@ -0,0 +1,34 @@
+#include "trace.h"
+#include <string.h>
+#ifdef TRACE_STAGES
+static TraceRecord_t records[TRACE_TICKS];
+static uint8_t head = 0;
+static uint8_t count = 0;
+uint16_t traceStart[TRACE_STAGE_COUNT];
+TraceRecord_t *traceCurrent = records;
+// Called at the start of tickInputs. tickLEDs and fillReport run after
+// tickInputs returns, so they end up in the same record as the inputs they
+// were working with.
+void traceTick(void) {
+  head = (head + 1) % TRACE_TICKS;
+  if (count < TRACE_TICKS) { count++; }
+  traceCurrent = &records[head];
+  memset(traceCurrent, 0, sizeof(TraceRecord_t));
+}
+uint8_t readTrace(uint8_t *buf) {
+  // The current record is still being filled in, so leave it out
+  uint8_t ready = count ? count - 1 : 0;
+  *buf++ = ready;
+  for (uint8_t i = 0; i < ready; i++) {
+    uint8_t idx = (head + TRACE_TICKS - ready + i) % TRACE_TICKS;
+    memcpy(buf, &records[idx], sizeof(TraceRecord_t));
+    buf += sizeof(TraceRecord_t);
+  }
+  return 1 + ready * sizeof(TraceRecord_t);
+}
+#else
+uint8_t readTrace(uint8_t *buf) {
+  *buf = 0;
+  return 1;
+}
+#endif
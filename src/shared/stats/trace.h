@@ -0,0 +1,39 @@
+#pragma once
+#include <stdint.h>
+// Per stage timings for the input pipeline. Build with TRACE_STAGES defined
+// to enable them, otherwise every TRACE_* macro compiles away to nothing and
+// COMMAND_GET_TRACE just returns no records.
+enum TraceStage {
+  TRACE_TICK_FUNCTION,
+  TRACE_DIRECT_INPUT,
+  TRACE_ANALOG,
+  TRACE_GUITAR,
+  TRACE_DJ,
+  TRACE_LEDS,
+  TRACE_FILL_REPORT,
+  TRACE_STAGE_COUNT
+};
+// One more than fits in a feature report, as the newest record is always
+// still being filled in
+#define TRACE_TICKS 5
+#ifdef TRACE_STAGES
+#  include "timer/timer.h"
+typedef struct {
+  // How long each stage took during a tick, in microseconds
+  uint16_t stages[TRACE_STAGE_COUNT];
+} TraceRecord_t;
+extern uint16_t traceStart[TRACE_STAGE_COUNT];
+extern TraceRecord_t *traceCurrent;
+void traceTick(void);
+#  define TRACE_TICK() traceTick()
+#  define TRACE_BEGIN(stage) traceStart[stage] = micros()
+#  define TRACE_END(stage)                                                     \
+    traceCurrent->stages[stage] = (uint16_t)micros() - traceStart[stage]
+#else
+#  define TRACE_TICK()
+#  define TRACE_BEGIN(stage)
+#  define TRACE_END(stage)
+#endif
+// Writes a count followed by the most recent records (oldest first) into
+// buf, and returns the amount of bytes written.
+uint8_t readTrace(uint8_t *buf);